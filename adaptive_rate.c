@@ -0,0 +1,301 @@
+/******************************************************************************
+* File Name: adaptive_rate.c
+*
+* Description: This file contains the adaptive sample rate scheduler. While the
+*              filtered readings stay within the stable window, the PASS timer
+*              period and the FIFO level are raised so that the SAR ADC converts
+*              and the CPU wakes up less often.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "adaptive_rate.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void adaptive_rate_apply(bool slow);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Default policy. ALS is watched with 2 counts and the thermistor channels with
+ * 3 counts (about 0.1 deg C at room temperature). */
+const adaptive_rate_policy_t adaptive_rate_default_policy =
+{
+    .stable_delta =
+    {
+        [REF_RESISTOR_CHANNEL] = 3,
+        [THERMISTOR_SENSOR_CHANNEL] = 3,
+        [ALS_SENSOR_CHANNEL] = 2
+    },
+    .stable_wake_count = 50,
+    .fast_timer_period = SAR_TIMER_PERIOD,
+    .slow_timer_period = SAR_TIMER_PERIOD * 4,
+    .fast_fifo_level = SAR_FIFO_LEVEL,
+    .slow_fifo_level = SAR_FIFO_LEVEL * 2
+};
+
+/* Policy in use; NULL when the scheduler is disabled */
+static const adaptive_rate_policy_t *adaptive_rate_policy = NULL;
+
+/* Filtered readings of the previous wake-up */
+static int32 adaptive_rate_last[FILTER_BANK_CHANNELS];
+
+/* Number of consecutive stable wake-ups */
+static uint16 adaptive_rate_stable_count = 0;
+
+/* Current mode, timer period and FIFO level */
+static bool adaptive_rate_slow = false;
+static uint32 adaptive_rate_timer_period = SAR_TIMER_PERIOD;
+static uint32 adaptive_rate_fifo_level = SAR_FIFO_LEVEL;
+
+/* Time spent in each mode */
+static adaptive_rate_stats_t adaptive_rate_stats = {0};
+
+
+/*******************************************************************************
+* Function Name: adaptive_rate_set_policy
+********************************************************************************
+* Summary:
+* This function selects the sample rate policy. The scheduler starts in fast
+* mode. Passing NULL disables the scheduler and keeps the fast mode of the
+* configuration in design.modus.
+*
+* Parameters:
+*  policy: policy to be used, or NULL
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void adaptive_rate_set_policy(const adaptive_rate_policy_t *policy)
+{
+    adaptive_rate_policy = policy;
+    adaptive_rate_stable_count = 0;
+
+    adaptive_rate_apply(false);
+}
+
+/*******************************************************************************
+* Function Name: adaptive_rate_update
+********************************************************************************
+* Summary:
+* This function compares the filtered readings with those of the previous
+* wake-up. After stable_wake_count stable wake-ups, the slow mode is selected;
+* the first change outside the stable window of a watched channel selects the
+* fast mode again.
+*
+* Parameters:
+*  filtered_data: filtered readings of all channels
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void adaptive_rate_update(const int32 *filtered_data)
+{
+    bool stable = true;
+    int32 delta;
+    uint8 channel;
+
+    if(adaptive_rate_slow)
+        adaptive_rate_stats.slow_time_ms += adaptive_rate_get_wake_period_ms();
+    else
+        adaptive_rate_stats.fast_time_ms += adaptive_rate_get_wake_period_ms();
+
+    if(adaptive_rate_policy == NULL)
+        return;
+
+    for(channel = 0; channel < FILTER_BANK_CHANNELS; channel++)
+    {
+        delta = filtered_data[channel] - adaptive_rate_last[channel];
+        adaptive_rate_last[channel] = filtered_data[channel];
+
+        if((adaptive_rate_policy->stable_delta[channel] != 0) &&
+           ((delta > adaptive_rate_policy->stable_delta[channel]) ||
+            (delta < -(int32)adaptive_rate_policy->stable_delta[channel])))
+            stable = false;
+    }
+
+    if(!stable)
+    {
+        adaptive_rate_stable_count = 0;
+
+        if(adaptive_rate_slow)
+            adaptive_rate_apply(false);
+    }
+    else if(!adaptive_rate_slow)
+    {
+        if(++adaptive_rate_stable_count >= adaptive_rate_policy->stable_wake_count)
+            adaptive_rate_apply(true);
+    }
+}
+
+/*******************************************************************************
+* Function Name: adaptive_rate_get_wake_period_ms
+********************************************************************************
+* Summary:
+* This function returns the wake-up period for the current timer period and
+* FIFO level.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Wake-up period in milliseconds
+*
+*******************************************************************************/
+uint32 adaptive_rate_get_wake_period_ms(void)
+{
+    uint32 period_ms;
+
+    /* FIFO level entries are collected in level / CHANNEL_COUNT scans */
+    period_ms = (adaptive_rate_fifo_level * adaptive_rate_timer_period * 1000UL) /
+                (SAR_TIMER_CLOCK_HZ * CHANNEL_COUNT);
+
+#if ENABLE_FIFO_DMA
+    period_ms *= FIFO_DMA_LEVELS_PER_BUFFER;
+#endif
+
+    return(period_ms);
+}
+
+/*******************************************************************************
+* Function Name: adaptive_rate_is_slow
+********************************************************************************
+* Summary:
+* This function returns whether the slow mode is active.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true in slow mode
+*
+*******************************************************************************/
+bool adaptive_rate_is_slow(void)
+{
+    return(adaptive_rate_slow);
+}
+
+/*******************************************************************************
+* Function Name: adaptive_rate_get_stats
+********************************************************************************
+* Summary:
+* This function returns the time spent in fast and slow mode. With the currents
+* of both modes, the average current is
+*   I = (I_fast * fast_time_ms + I_slow * slow_time_ms) / (fast_time_ms + slow_time_ms)
+*
+* Parameters:
+*  stats: structure to be filled
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void adaptive_rate_get_stats(adaptive_rate_stats_t *stats)
+{
+    *stats = adaptive_rate_stats;
+}
+
+/*******************************************************************************
+* Function Name: adaptive_rate_apply
+********************************************************************************
+* Summary:
+* This function reprograms the PASS timer period and the FIFO level for the
+* selected mode. The timer is stopped while the period is changed, and the
+* filters of the scanned channels are retuned to the new sample rate, so that
+* their cut-off frequencies are the same in both modes. It is called right
+* after the FIFO is drained and filtered, so the new level applies to a nearly
+* empty FIFO and the new coefficients to the samples of the new rate.
+*
+* Parameters:
+*  slow: true to select the slow mode
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void adaptive_rate_apply(bool slow)
+{
+    uint32 timer_period = SAR_TIMER_PERIOD;
+    uint32 fifo_level = SAR_FIFO_LEVEL;
+    uint32 rate_divider;
+    uint8 channel;
+
+    if(adaptive_rate_policy != NULL)
+    {
+        timer_period = slow ? adaptive_rate_policy->slow_timer_period : adaptive_rate_policy->fast_timer_period;
+        fifo_level = slow ? adaptive_rate_policy->slow_fifo_level : adaptive_rate_policy->fast_fifo_level;
+    }
+
+#if ENABLE_FIFO_DMA
+    /* DMA descriptors move exactly SAR_FIFO_LEVEL entries per trigger */
+    fifo_level = SAR_FIFO_LEVEL;
+#endif
+
+    if(slow != adaptive_rate_slow)
+        adaptive_rate_stats.switch_count++;
+
+    if(timer_period != adaptive_rate_timer_period)
+    {
+        Cy_SysAnalog_TimerDisable(PASS);
+        Cy_SysAnalog_TimerSetPeriod(PASS, timer_period);
+        Cy_SysAnalog_TimerEnable(PASS);
+
+        /* The descriptors are tuned for SAR_TIMER_PERIOD */
+        rate_divider = (timer_period + (SAR_TIMER_PERIOD / 2UL)) / SAR_TIMER_PERIOD;
+
+        if(rate_divider == 0UL)
+            rate_divider = 1UL;
+
+        for(channel = 0; channel < FILTER_BANK_CHANNELS; channel++)
+        {
+            if((SAR_SCAN_CHANNEL_MASK & (1UL << channel)) != 0UL)
+                filter_bank_retune(channel, rate_divider, 0U);
+        }
+    }
+
+    if(fifo_level != adaptive_rate_fifo_level)
+        APP_SAR_FIFO_LEVEL = fifo_level - 1UL;
+
+    adaptive_rate_slow = slow;
+    adaptive_rate_timer_period = timer_period;
+    adaptive_rate_fifo_level = fifo_level;
+}
+
+/* [] END OF FILE */
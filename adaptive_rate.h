@@ -0,0 +1,110 @@
+/******************************************************************************
+* File Name: adaptive_rate.h
+*
+* Description: This file contains the interface of the adaptive sample rate
+*              scheduler. The scan rate and FIFO level are lowered while the
+*              filtered readings are stable and restored when they change.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef ADAPTIVE_RATE_H_
+#define ADAPTIVE_RATE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+#include "filter_bank.h"
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Sample rate policy */
+typedef struct
+{
+    /* Largest change of the filtered reading of a channel between two wake-ups,
+     * in ADC counts, that is considered stable. 0 excludes the channel. */
+    uint16 stable_delta[FILTER_BANK_CHANNELS];
+
+    /* Number of consecutive stable wake-ups before switching to slow mode */
+    uint16 stable_wake_count;
+
+    /* PASS timer period in fast and slow mode, in timer clock cycles */
+    uint32 fast_timer_period;
+    uint32 slow_timer_period;
+
+    /* FIFO level in fast and slow mode; must be a multiple of CHANNEL_COUNT.
+     * Ignored in DMA mode where the FIFO level is fixed. */
+    uint16 fast_fifo_level;
+    uint16 slow_fifo_level;
+} adaptive_rate_policy_t;
+
+/* Time spent in each mode, used to estimate the average current */
+typedef struct
+{
+    uint32 fast_time_ms;
+    uint32 slow_time_ms;
+    uint32 switch_count;
+} adaptive_rate_stats_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Default policy: 400 sps / 100 ms wake-up in fast mode, 100 sps / 800 ms
+ * wake-up in slow mode */
+extern const adaptive_rate_policy_t adaptive_rate_default_policy;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to select the policy; NULL disables the scheduler and restores the
+ * fast mode */
+void adaptive_rate_set_policy(const adaptive_rate_policy_t *policy);
+
+/* Function to update the scheduler with the filtered readings of a wake-up */
+void adaptive_rate_update(const int32 *filtered_data);
+
+/* Function to get the current wake-up period in milliseconds */
+uint32 adaptive_rate_get_wake_period_ms(void);
+
+/* Function to check whether the slow mode is active */
+bool adaptive_rate_is_slow(void);
+
+/* Function to get the time spent in each mode */
+void adaptive_rate_get_stats(adaptive_rate_stats_t *stats);
+
+#endif /* ADAPTIVE_RATE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,256 @@
+/******************************************************************************
+* File Name: als_range.c
+*
+* Description: This file contains the ALS range detection wake-up. The SAR
+*              compares every ALS result with the threshold opposite to the
+*              current LED state and interrupts the CPU on a crossing, so the
+*              LED is no longer switched from the periodic FIFO wake-up.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "als_range.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* NVIC line of the SAR interrupt when the sensing runs on CM0+ */
+#define ALS_RANGE_IRQ_CM0P_LINE             (3UL)
+
+/* Range detection interrupt mask of the ALS channel */
+#define ALS_RANGE_CHANNEL_MASK              (1UL << ALS_SENSOR_CHANNEL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void als_range_interrupt_handler(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* SAR interrupt configuration structure; same priority as the FIFO interrupt */
+static const cy_stc_sysint_t als_range_irq_cfg = {
+    .intrSrc = APP_INTR_SRC(pass_interrupt_sar_0_IRQn, ALS_RANGE_IRQ_CM0P_LINE),
+    .intrPriority = 7
+};
+
+/* This flag is set in the SAR interrupt handler */
+static volatile bool als_range_event = false;
+
+/* Number of range detection wake-ups */
+static uint32 als_range_event_count = 0;
+
+/* Timer clock cycles not yet accounted for by als_range_get_period_ms */
+static uint32 als_range_residue = 0;
+
+
+/*******************************************************************************
+* Function Name: als_range_init
+********************************************************************************
+* Summary:
+* This function selects the scan rate and the FIFO level of the range detection
+* mode and enables the SAR interrupt. The range detection stays disarmed till
+* als_range_arm is called. It must be called after Cy_SAR_Enable and before the
+* timer is enabled.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void als_range_init(void)
+{
+    Cy_SysAnalog_TimerSetPeriod(PASS, ALS_RANGE_TIMER_PERIOD);
+    APP_SAR_FIFO_LEVEL = ALS_RANGE_FIFO_LEVEL - 1UL;
+
+    als_range_set_limits();
+    Cy_SAR_SetRangeInterruptMask(SAR0, 0UL);
+    Cy_SAR_ClearRangeInterrupt(SAR0, ALS_RANGE_CHANNEL_MASK);
+
+    (void)Cy_SysInt_Init(&als_range_irq_cfg, als_range_interrupt_handler);
+    NVIC_EnableIRQ(APP_NVIC_IRQN(pass_interrupt_sar_0_IRQn, ALS_RANGE_IRQ_CM0P_LINE));
+}
+
+/*******************************************************************************
+* Function Name: als_range_set_limits
+********************************************************************************
+* Summary:
+* This function loads ALS_RANGE_LOW_LIMIT and ALS_RANGE_HIGH_LIMIT into the
+* range detection. With ENABLE_CALIBRATION, the limits follow the gain and
+* offset of the device, so it is called again when they change.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void als_range_set_limits(void)
+{
+    Cy_SAR_SetLowLimit(SAR0, ALS_RANGE_LOW_LIMIT);
+    Cy_SAR_SetHighLimit(SAR0, ALS_RANGE_HIGH_LIMIT);
+}
+
+/*******************************************************************************
+* Function Name: als_range_arm
+********************************************************************************
+* Summary:
+* This function arms the range detection of the ALS channel. While the LED is
+* OFF, a result below ALS_RANGE_LOW_LIMIT raises the interrupt; while the LED
+* is ON, a result of ALS_RANGE_HIGH_LIMIT or more does. This gives the same
+* hysteresis as the ALS_LOW_THRESHOLD and ALS_HIGH_THRESHOLD comparison.
+*
+* Parameters:
+*  led_on: current state of the user LED
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void als_range_arm(bool led_on)
+{
+    Cy_SAR_SetRangeInterruptMask(SAR0, 0UL);
+
+    Cy_SAR_SetRangeCond(SAR0, led_on ? CY_SAR_RANGE_COND_ABOVE : CY_SAR_RANGE_COND_BELOW);
+
+    /* Discard the events of the previous condition */
+    Cy_SAR_ClearRangeInterrupt(SAR0, ALS_RANGE_CHANNEL_MASK);
+
+    Cy_SAR_SetRangeInterruptMask(SAR0, ALS_RANGE_CHANNEL_MASK);
+}
+
+/*******************************************************************************
+* Function Name: als_range_get_event
+********************************************************************************
+* Summary:
+* This function returns whether the range detection interrupt occurred since
+* the last call and clears the event.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if a threshold crossing was detected
+*
+*******************************************************************************/
+bool als_range_get_event(void)
+{
+    if(!als_range_event)
+        return(false);
+
+    als_range_event = false;
+    als_range_event_count++;
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: als_range_get_period_ms
+********************************************************************************
+* Summary:
+* This function returns the time in which the SAR collected the given number of
+* FIFO entries. A range detection wake-up reads a partly filled FIFO, so the
+* wake-up period is derived from the number of entries read. The remainder is
+* carried to the next call so the uptime does not drift.
+*
+* Parameters:
+*  fifo_count: number of FIFO entries read in this wake-up
+*
+* Return:
+*  Period in milliseconds
+*
+*******************************************************************************/
+uint32 als_range_get_period_ms(uint32 fifo_count)
+{
+    uint32 cycles;
+    uint32 period_ms;
+
+    /* CHANNEL_COUNT entries are collected per timer period; cycles are kept in
+     * units of 1/CHANNEL_COUNT timer clock cycle */
+    cycles = (fifo_count * ALS_RANGE_TIMER_PERIOD * 1000UL) + als_range_residue;
+
+    period_ms = cycles / (SAR_TIMER_CLOCK_HZ * CHANNEL_COUNT);
+    als_range_residue = cycles % (SAR_TIMER_CLOCK_HZ * CHANNEL_COUNT);
+
+    return(period_ms);
+}
+
+/*******************************************************************************
+* Function Name: als_range_get_event_count
+********************************************************************************
+* Summary:
+* This function returns the number of range detection wake-ups.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of wake-ups
+*
+*******************************************************************************/
+uint32 als_range_get_event_count(void)
+{
+    return(als_range_event_count);
+}
+
+/*******************************************************************************
+* Function Name: als_range_interrupt_handler
+********************************************************************************
+* Summary:
+* This function is the handler for the SAR range detection interrupt. The
+* detection is disarmed since the condition holds for every following result
+* till the LED is switched.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void als_range_interrupt_handler(void)
+{
+    Cy_SAR_SetRangeInterruptMask(SAR0, 0UL);
+    Cy_SAR_ClearRangeInterrupt(SAR0, ALS_RANGE_CHANNEL_MASK);
+
+    /* Set the flag */
+    als_range_event = true;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,102 @@
+/******************************************************************************
+* File Name: als_range.h
+*
+* Description: This file contains the declarations of the ALS range detection
+*              wake-up used by the PSoC 6 MCU SAR ADC Low-Power Sensing -
+*              Thermistor and ALS example.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef ALS_RANGE_H_
+#define ALS_RANGE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+#if ENABLE_CALIBRATION
+#include "calibration.h"
+#endif
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* PASS timer period in range detection mode: 410 cycles of LFCLK = 12.5ms, that
+ * is, 80 sps. The user LED follows a threshold crossing within one scan. */
+#define ALS_RANGE_TIMER_PERIOD              (410)
+
+/* FIFO level in range detection mode: 240 entries / (80 sps * 3 channels) =
+ * 1s between the periodic wake-ups */
+#define ALS_RANGE_FIFO_LEVEL                (240)
+
+/* ADC counts of the ALS channel at the thresholds of get_light_intensity. The
+ * LED is turned ON below ALS_RANGE_LOW_LIMIT and OFF from ALS_RANGE_HIGH_LIMIT
+ * on. */
+#if ENABLE_CALIBRATION
+#define ALS_RANGE_LOW_LIMIT                 (calibration_get_light_count(ALS_LOW_THRESHOLD))
+#define ALS_RANGE_HIGH_LIMIT                (calibration_get_light_count(ALS_HIGH_THRESHOLD + 1))
+#else
+#define ALS_RANGE_LOW_LIMIT                 ((((ALS_LOW_THRESHOLD + ALS_OFFSET) * 1024UL) + 99UL) / 100UL)
+#define ALS_RANGE_HIGH_LIMIT                ((((ALS_HIGH_THRESHOLD + ALS_OFFSET + 1UL) * 1024UL) + 99UL) / 100UL)
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to select the range detection scan rate and FIFO level and to
+ * enable the SAR interrupt */
+void als_range_init(void);
+
+/* Function to load the thresholds of the range detection, after a change of
+ * the ALS calibration */
+void als_range_set_limits(void);
+
+/* Function to arm the range detection for the threshold opposite to the
+ * current LED state */
+void als_range_arm(bool led_on);
+
+/* Function to check and clear the range detection event */
+bool als_range_get_event(void);
+
+/* Function to get the time covered by the given number of FIFO entries */
+uint32 als_range_get_period_ms(uint32 fifo_count);
+
+/* Function to get the number of range detection wake-ups */
+uint32 als_range_get_event_count(void);
+
+#endif /* ALS_RANGE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,464 @@
+/******************************************************************************
+* File Name: app_config.h
+*
+* Description: This file contains the build-time options of the PSoC 6 MCU SAR ADC
+*              Low-Power Sensing - Thermistor and ALS example. Each option can be
+*              overridden from the DEFINES variable in the Makefile.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_CONFIG_H_
+#define APP_CONFIG_H_
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Set to 1 to measure the thermistor with its differential channel only and
+ * take the ratio to the reference resistor from the SAR reference (VDDA),
+ * which also excites the divider. Channel 0 is removed from the scan, which
+ * saves one conversion in three. Set to 0 to measure both resistors. */
+#ifndef ENABLE_RATIOMETRIC_THERMISTOR
+#define ENABLE_RATIOMETRIC_THERMISTOR       (0)
+#endif
+
+/* Channels, sensors and filters of the pipeline */
+#include "sensor_config.h"
+
+#if ENABLE_RATIOMETRIC_THERMISTOR
+/* FIFO level set at run time; keeps the 100-ms wake-up with two channels */
+#define SAR_FIFO_LEVEL                      (80)
+#else
+/* FIFO level configured for the SAR ADC in design.modus. CPU (or DMA) is
+ * notified every time the FIFO accumulates this many entries. */
+#define SAR_FIFO_LEVEL                      (120)
+#endif
+
+/* Period of one FIFO level event in milliseconds: 120 entries / (400 sps * 3
+ * channels), or 80 entries / (400 sps * 2 channels) */
+#define SAR_FIFO_LEVEL_PERIOD_MS            (100)
+
+/* PASS timer period in timer clock cycles (LFCLK, 32.768 kHz) configured in
+ * design.modus: 82 cycles = 2.5ms, that is, 400 sps */
+#define SAR_TIMER_PERIOD                    (82)
+#define SAR_TIMER_CLOCK_HZ                  (32768)
+
+/* ALS offset in Percent */
+/* To configure this value, begin with offset of 0 and note down the lowest ALS
+percent value. Configure the ALS_OFFSET with the lowest observed ALS percent. */
+#define ALS_OFFSET                          (20)
+
+/* ALS low threshold value - if ALS percentage is lower than this value, user
+ * LED is turned ON */
+#define ALS_LOW_THRESHOLD                   (45)
+
+/* ALS high threshold value - if ALS percentage is higher than this value, user
+ * LED is turned OFF */
+#define ALS_HIGH_THRESHOLD                  (55)
+
+/* Interval at which the readings are sent over UART */
+#define DISPLAY_PERIOD_MS                   (500)
+
+/* Set to 1 to move the FIFO contents to RAM using a DataWire (DMA) channel.
+ * CPU then wakes up only when FIFO_DMA_LEVELS_PER_BUFFER FIFO level events
+ * are collected in one half of the double buffer. */
+#ifndef ENABLE_FIFO_DMA
+#define ENABLE_FIFO_DMA                     (0)
+#endif
+
+/* Number of FIFO level events collected in each half of the DMA double buffer.
+ * Wake-up period of the CPU is FIFO_DMA_LEVELS_PER_BUFFER x 100ms. */
+#ifndef FIFO_DMA_LEVELS_PER_BUFFER
+#define FIFO_DMA_LEVELS_PER_BUFFER          (5)
+#endif
+
+/* Set to 1 to convert the thermistor readings into temperature with the lookup
+ * table in thermistor_lut.c. Set to 0 to use the floating point Beta equation
+ * (requires logf). */
+#ifndef ENABLE_THERMISTOR_LUT
+#define ENABLE_THERMISTOR_LUT               (1)
+#endif
+
+/* Set to 1 to send the readings with an asynchronous DMA transfer and wait for
+ * its completion in CPU Sleep mode. Set to 0 to use printf and poll the UART
+ * before entering deep sleep. */
+#ifndef ENABLE_ASYNC_TELEMETRY
+#define ENABLE_ASYNC_TELEMETRY              (1)
+#endif
+
+/* Format of the readings sent over UART: TELEMETRY_FORMAT_ASCII (0) for text
+ * lines or TELEMETRY_FORMAT_BINARY (1) for the 13-byte frame described in
+ * telemetry.c and README.md */
+#ifndef TELEMETRY_FORMAT
+#define TELEMETRY_FORMAT                    (0)
+#endif
+
+/* Set to 1 to log every reading into a RAM block and send the block in one
+ * burst when it reaches the watermark or when the host sends 'F', instead of
+ * sending one reading every 500ms. See sample_log.c for the format. */
+#ifndef ENABLE_SAMPLE_LOG
+#define ENABLE_SAMPLE_LOG                   (0)
+#endif
+
+/* Set to 1 to measure the active CPU cycles of each phase of the wake-up with
+ * the DWT cycle counter. The statistics are printed when the host sends 'P'. */
+#ifndef ENABLE_CYCLE_PROFILE
+#define ENABLE_CYCLE_PROFILE                (0)
+#endif
+
+/* Wake-up period of the CPU in milliseconds */
+#if ENABLE_FIFO_DMA
+#define WAKE_PERIOD_MS                      (SAR_FIFO_LEVEL_PERIOD_MS * FIFO_DMA_LEVELS_PER_BUFFER)
+#else
+#define WAKE_PERIOD_MS                      (SAR_FIFO_LEVEL_PERIOD_MS)
+#endif
+
+/* Set to 1 to lower the scan rate and raise the FIFO level while the filtered
+ * readings are stable. See adaptive_rate.h for the policy. */
+#ifndef ENABLE_ADAPTIVE_RATE
+#define ENABLE_ADAPTIVE_RATE                (0)
+#endif
+
+/* Set to 1 to switch the user LED from the SAR range detection interrupt of the
+ * ALS channel. The scan rate is lowered and the FIFO level raised so that the
+ * periodic wake-up for the thermistor readout happens about once per second.
+ * See als_range.h. */
+#ifndef ENABLE_ALS_RANGE_WAKE
+#define ENABLE_ALS_RANGE_WAKE               (0)
+#endif
+
+#if ENABLE_ALS_RANGE_WAKE && (ENABLE_ADAPTIVE_RATE || ENABLE_FIFO_DMA)
+#error "ENABLE_ALS_RANGE_WAKE cannot be combined with ENABLE_ADAPTIVE_RATE or ENABLE_FIFO_DMA"
+#endif
+
+/* Set to 1 to move the FIFO entries into a RAM ring from the FIFO interrupt.
+ * The main loop reads the ring, so a late wake-up no longer lets the FIFO
+ * overflow and the entries that do not fit are counted. See sample_ring.c. */
+#ifndef ENABLE_SAMPLE_RING
+#define ENABLE_SAMPLE_RING                  (0)
+#endif
+
+#if ENABLE_SAMPLE_RING && (ENABLE_FIFO_DMA || ENABLE_ALS_RANGE_WAKE)
+#error "ENABLE_SAMPLE_RING cannot be combined with ENABLE_FIFO_DMA or ENABLE_ALS_RANGE_WAKE"
+#endif
+
+/* Set to 1 to average every channel over 16 conversions in the SAR sequencer
+ * and scan at 25 sps instead of 400 sps; the software filters are retuned to
+ * match. The averaging can be changed at run time with hw_average_set. */
+#ifndef ENABLE_HW_AVERAGE
+#define ENABLE_HW_AVERAGE                   (0)
+#endif
+
+#if ENABLE_HW_AVERAGE && (ENABLE_ADAPTIVE_RATE || ENABLE_ALS_RANGE_WAKE)
+#error "ENABLE_HW_AVERAGE cannot be combined with ENABLE_ADAPTIVE_RATE or ENABLE_ALS_RANGE_WAKE"
+#endif
+
+/* Set to 1 to count FIFO overflow and underflow events and the FIFO entries
+ * missing from the channel sequence, and flag the readings computed after a
+ * loss. See fifo_monitor.c. */
+#ifndef ENABLE_FIFO_MONITOR
+#define ENABLE_FIFO_MONITOR                 (0)
+#endif
+
+/* Set to 1 to power the sensor dividers from a GPIO only while the SAR scans
+ * them. The scans are then taken in windows of EXCITATION_WINDOW_SCANS scans
+ * started every EXCITATION_WINDOW_PERIOD_MS by a low-power timer, each after
+ * EXCITATION_SETTLING_US of settling. See excitation.c. */
+#ifndef ENABLE_EXCITATION_GATING
+#define ENABLE_EXCITATION_GATING            (0)
+#endif
+
+#ifndef EXCITATION_WINDOW_SCANS
+#define EXCITATION_WINDOW_SCANS             (8)
+#endif
+
+#ifndef EXCITATION_WINDOW_PERIOD_MS
+#define EXCITATION_WINDOW_PERIOD_MS         (100)
+#endif
+
+#ifndef EXCITATION_SETTLING_US
+#define EXCITATION_SETTLING_US              (100)
+#endif
+
+/* Set to 1 to take BURST_SCANS scans every BURST_PERIOD_MS with a PASS timer
+ * period of BURST_TIMER_PERIOD and report the mean of each channel instead
+ * of the IIR output. The SAR, AREF and LPOSC are disabled between the bursts.
+ * The bursts are the windows of excitation.c, so the divider supplies are
+ * gated as well when ENABLE_EXCITATION_GATING is set. */
+#ifndef ENABLE_BURST_MODE
+#define ENABLE_BURST_MODE                   (0)
+#endif
+
+#ifndef BURST_SCANS
+#define BURST_SCANS                         (16)
+#endif
+
+#ifndef BURST_PERIOD_MS
+#define BURST_PERIOD_MS                     (500)
+#endif
+
+/* 12 timer clock cycles = 366 us, that is, 2730 sps; the scan of the three
+ * channels without hardware averaging takes 300 us */
+#ifndef BURST_TIMER_PERIOD
+#define BURST_TIMER_PERIOD                  (12)
+#endif
+
+/* Scans are taken in windows started by the low-power timer */
+#define ENABLE_SCAN_WINDOWS                 (ENABLE_EXCITATION_GATING || ENABLE_BURST_MODE)
+
+#if ENABLE_SCAN_WINDOWS && (ENABLE_ADAPTIVE_RATE || ENABLE_ALS_RANGE_WAKE || ENABLE_FIFO_DMA || ENABLE_HW_AVERAGE)
+#error "ENABLE_EXCITATION_GATING and ENABLE_BURST_MODE cannot be combined with ENABLE_ADAPTIVE_RATE, ENABLE_ALS_RANGE_WAKE, ENABLE_FIFO_DMA or ENABLE_HW_AVERAGE"
+#endif
+
+#if ENABLE_EXCITATION_GATING && !ENABLE_BURST_MODE && ((EXCITATION_WINDOW_SCANS * CHANNEL_COUNT) > SAR_FIFO_LEVEL)
+#error "EXCITATION_WINDOW_SCANS exceeds the scans of one FIFO level"
+#endif
+
+/* The samples of a burst must fit in the filter bank block */
+#if ENABLE_BURST_MODE && ((BURST_SCANS * CHANNEL_COUNT) >= SAR_FIFO_LEVEL)
+#error "BURST_SCANS must be lower than the scans of one FIFO level"
+#endif
+
+/* Set to 1 to build the raw FIFO capture: when started by the host, every FIFO
+ * entry is sent over the UART as a 12-bit result with a channel tag, in one
+ * frame per wake-up, instead of the readings */
+#ifndef ENABLE_FIFO_CAPTURE
+#define ENABLE_FIFO_CAPTURE                 (0)
+#endif
+
+/* Accumulated hardware averaging results do not fit the 12-bit capture */
+#if ENABLE_FIFO_CAPTURE && (ENABLE_HW_AVERAGE || ENABLE_SAMPLE_LOG)
+#error "ENABLE_FIFO_CAPTURE cannot be combined with ENABLE_HW_AVERAGE or ENABLE_SAMPLE_LOG"
+#endif
+
+/* Set to 1 to append a reading every FLASH_LOG_INTERVAL_MS to a ring of rows in
+ * the work flash, and to upload the readings from a sequence number on when
+ * the host sends 'U' followed by the number. See flash_log.c for the format. */
+#ifndef ENABLE_FLASH_LOG
+#define ENABLE_FLASH_LOG                    (0)
+#endif
+
+/* Interval of the readings logged into the flash in milliseconds */
+#ifndef FLASH_LOG_INTERVAL_MS
+#define FLASH_LOG_INTERVAL_MS               (60000U)
+#endif
+
+/* The upload takes the UART over from the frames of both */
+#if ENABLE_FLASH_LOG && (ENABLE_FIFO_CAPTURE || ENABLE_SAMPLE_LOG)
+#error "ENABLE_FLASH_LOG cannot be combined with ENABLE_FIFO_CAPTURE or ENABLE_SAMPLE_LOG"
+#endif
+
+/* Set to 1 to convert the readings with coefficients stored per device in the
+ * work flash: Steinhart-Hart A, B and C for the thermistor and gain and offset
+ * for the ALS, fitted in the field from the reference points sent by the host
+ * with 'K' and 'L'. The Beta model and ALS_OFFSET are used till then. */
+#ifndef ENABLE_CALIBRATION
+#define ENABLE_CALIBRATION                  (0)
+#endif
+
+/* The coefficients are applied as a thermistor table */
+#if ENABLE_CALIBRATION && !ENABLE_THERMISTOR_LUT
+#error "ENABLE_CALIBRATION requires ENABLE_THERMISTOR_LUT"
+#endif
+
+/* Set to 1 to dim the user LED with a TCPWM PWM in proportion to the ambient
+ * light instead of switching it at ALS_LOW_THRESHOLD and ALS_HIGH_THRESHOLD.
+ * The TCPWM does not run in System Deep Sleep, which is held off while the LED
+ * is dimmed; see led_dimmer.c. */
+#ifndef ENABLE_LED_DIMMING
+#define ENABLE_LED_DIMMING                  (0)
+#endif
+
+/* The range detection only sees the two thresholds */
+#if ENABLE_LED_DIMMING && ENABLE_ALS_RANGE_WAKE
+#error "ENABLE_LED_DIMMING cannot be combined with ENABLE_ALS_RANGE_WAKE"
+#endif
+
+/* Set to 1 to keep running statistics and a sliding-window slope of the sensor
+ * outputs, and to send an event over UART when an alarm rule fires (see
+ * trend.c for the default rules) */
+#ifndef ENABLE_TREND_ALARMS
+#define ENABLE_TREND_ALARMS                 (0)
+#endif
+
+/* With ENABLE_TREND_ALARMS, set to 1 to keep sending the readings every
+ * DISPLAY_PERIOD_MS. With 0, the UART only carries the alarm events and the
+ * replies to the host commands. */
+#ifndef TREND_KEEP_REPORTS
+#define TREND_KEEP_REPORTS                  (0)
+#endif
+
+/* The readings are sent every DISPLAY_PERIOD_MS unless only the alarm events
+ * are to be sent */
+#define DISPLAY_REPORTS                     (!ENABLE_TREND_ALARMS || TREND_KEEP_REPORTS)
+
+/* Set to 1 to expose the latest reading, the filtered counts and a history of
+ * readings as an I2C slave register map, which a host MCU reads on demand */
+#ifndef ENABLE_REGISTER_MAP
+#define ENABLE_REGISTER_MAP                 (0)
+#endif
+
+/* With ENABLE_REGISTER_MAP, set to 1 to wake the device from System Deep Sleep
+ * on an I2C address match. This needs the deep sleep SCB of the device on
+ * CYBSP_I2C_SDA/CYBSP_I2C_SCL. Set to 0 on another SCB; the host reads then
+ * succeed only while the device is awake. */
+#ifndef REGISTER_MAP_DEEP_SLEEP_WAKE
+#define REGISTER_MAP_DEEP_SLEEP_WAKE        (1)
+#endif
+
+/* Set to 1 to generate the filter and conversion code from SENSOR_CONFIG in
+ * sensor_config.h: each channel runs its filter engine with constant
+ * parameters, and each sensor its conversion, without a table look-up or an
+ * indirect call. The filter engines cannot be changed at run time. */
+#ifndef ENABLE_STATIC_PIPELINE
+#define ENABLE_STATIC_PIPELINE              (0)
+#endif
+
+/* Set to 1 to reset the device with the watchdog when the readings stop, and
+ * to keep the filter outputs and the sequence number of the binary frames in
+ * retained RAM across a watchdog or a software reset. After such a reset, the
+ * first reading is settled and the startup does not wait for the RTC. */
+#ifndef ENABLE_WARM_RESTART
+#define ENABLE_WARM_RESTART                 (0)
+#endif
+
+/* Set to 1 to replay a synthetic FIFO stream through the filter bank and the
+ * sensor conversions at startup, and print the checksum of the outputs (and
+ * the cycle counts with ENABLE_CYCLE_PROFILE) before the sampling starts */
+#ifndef ENABLE_PIPELINE_CHECK
+#define ENABLE_PIPELINE_CHECK               (0)
+#endif
+
+/* Set to 1 to timestamp the readings with the low-power timer (MCWDT) and the
+ * RTC, and to send them at DISPLAY_PERIOD_MS boundaries of the wall-clock
+ * time. Set to 0 to derive the timestamps from the number of wake-ups. */
+#ifndef ENABLE_RTC_TIMESTAMP
+#define ENABLE_RTC_TIMESTAMP                (1)
+#endif
+
+/* With ENABLE_RTC_TIMESTAMP, set to 1 to clock LFCLK from the 32.768 kHz watch
+ * crystal (WCO) instead of the ILO, whose frequency can be off by several
+ * percent. LFCLK also clocks the PASS timer, so the sample rate becomes exact
+ * too. The ILO is kept if the WCO does not start. */
+#ifndef TIMEBASE_USE_WCO
+#define TIMEBASE_USE_WCO                    (1)
+#endif
+
+/* Set to 1 to run the sampling, the filter bank and the LED control on CM0+.
+ * The application is then built once per core (see README.md); the CM4 image
+ * only receives the readings over the IPC pipe and sends them over UART. */
+#ifndef ENABLE_CM0P_SENSING
+#define ENABLE_CM0P_SENSING                 (0)
+#endif
+
+/* With ENABLE_CM0P_SENSING, set to 0 to keep CM4 powered down. CM0+ then sends
+ * the readings over UART itself. */
+#ifndef ENABLE_CM4
+#define ENABLE_CM4                          (1)
+#endif
+
+/* Readings are sent over UART by the core that samples them unless CM0+ passes
+ * them to CM4 */
+#define SENSING_CORE_TELEMETRY              (!(ENABLE_CM0P_SENSING && ENABLE_CM4))
+
+#if ENABLE_FIFO_CAPTURE && !SENSING_CORE_TELEMETRY
+#error "ENABLE_FIFO_CAPTURE requires the UART on the sensing core"
+#endif
+
+#if ENABLE_FLASH_LOG && !SENSING_CORE_TELEMETRY
+#error "ENABLE_FLASH_LOG requires the UART on the sensing core"
+#endif
+
+#if ENABLE_TREND_ALARMS && !SENSING_CORE_TELEMETRY
+#error "ENABLE_TREND_ALARMS requires the UART on the sensing core"
+#endif
+
+#if ENABLE_TREND_ALARMS && ENABLE_SAMPLE_LOG
+#error "ENABLE_TREND_ALARMS cannot be combined with ENABLE_SAMPLE_LOG"
+#endif
+
+#if ENABLE_PIPELINE_CHECK && !SENSING_CORE_TELEMETRY
+#error "ENABLE_PIPELINE_CHECK requires the UART on the sensing core"
+#endif
+
+#if ENABLE_CM0P_SENSING && ENABLE_CYCLE_PROFILE
+#error "ENABLE_CYCLE_PROFILE requires the DWT cycle counter of CM4"
+#endif
+
+/* Set to 1 to read a command character from the host on each wake-up, such as
+ * the T request of the wall-clock time. It is set by default only with the
+ * options that are driven by a host command. */
+#ifndef ENABLE_HOST_COMMANDS
+#define ENABLE_HOST_COMMANDS                (ENABLE_CYCLE_PROFILE || ENABLE_FIFO_CAPTURE || ENABLE_FLASH_LOG || \
+                                             ENABLE_CALIBRATION || ENABLE_TREND_ALARMS || ENABLE_FIFO_MONITOR || \
+                                             ENABLE_SAMPLE_LOG)
+#endif
+
+#if !ENABLE_HOST_COMMANDS && (ENABLE_CYCLE_PROFILE || ENABLE_FIFO_CAPTURE || ENABLE_FLASH_LOG || ENABLE_CALIBRATION || ENABLE_FIFO_MONITOR)
+#error "ENABLE_CYCLE_PROFILE, ENABLE_FIFO_CAPTURE, ENABLE_FLASH_LOG, ENABLE_CALIBRATION and ENABLE_FIFO_MONITOR require ENABLE_HOST_COMMANDS"
+#endif
+
+#if ENABLE_STATIC_PIPELINE && (ENABLE_HW_AVERAGE || ENABLE_SCAN_WINDOWS)
+#error "ENABLE_STATIC_PIPELINE cannot be combined with filters retuned at run time"
+#endif
+
+/* Placement of the data kept in the work flash, such as the flash log and the
+ * calibration row. The linker scripts of the BSP place the .cy_em_eeprom
+ * section in the work flash region of APP_WORK_FLASH_SIZE bytes. The data is
+ * written with cyhal_flash_write only; it is not declared const so that reads
+ * are not folded into the initial value. Programming the application clears
+ * it. */
+#define APP_WORK_FLASH_SECTION              CY_SECTION(".cy_em_eeprom")
+#define APP_WORK_FLASH_SIZE                 (0x8000UL)
+
+/* FIFO registers of SAR0: the level, stored as LEVEL - 1, and the read data
+ * (result in bits 0-15, channel in bits 16-19). The PASS_FIFO accessors take
+ * the SAR base. */
+#define APP_SAR_FIFO_LEVEL                  (PASS_FIFO_LEVEL(SAR0))
+#define APP_SAR_FIFO_RD_DATA                (PASS_FIFO_RD_DATA(SAR0))
+
+/* Interrupt source and NVIC line of a system interrupt used by the sensing. On
+ * CM0+, the system interrupt is routed to the given NVIC multiplexer line,
+ * which must be one of the deep sleep capable lines; intrSrc then holds the
+ * multiplexer line in bits 16 and up and the system interrupt below them. */
+#define APP_INTR_SRC(irqn, cm0p_line)       ((CY_CPU_CORTEX_M0P) ? \
+                                             (IRQn_Type)(((uint32)(cm0p_line) << 16) | (uint32)(irqn)) : \
+                                             (IRQn_Type)(irqn))
+#define APP_NVIC_IRQN(irqn, cm0p_line)      ((CY_CPU_CORTEX_M0P) ? (IRQn_Type)(cm0p_line) : (IRQn_Type)(irqn))
+
+#endif /* APP_CONFIG_H_ */
+
+/* [] END OF FILE */
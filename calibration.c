@@ -0,0 +1,608 @@
+/******************************************************************************
+* File Name: calibration.c
+*
+* Description: This file contains the per-device sensor calibration. The
+*              coefficients are stored in a row of the work flash and turned into
+*              a thermistor table and an ALS gain at load time, so that each
+*              reading costs a table lookup and a multiply.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "cyhal.h"
+#include "calibration.h"
+#include "sensor_table.h"
+#include "telemetry.h"
+#include "thermistor_lut.h"
+
+#if ENABLE_CALIBRATION
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Reference resistor in series with the thermistor in ohm */
+#define CALIBRATION_R_REFERENCE             (10000.0)
+
+/* Beta model of the NCP18XH103F03RB thermistor used before calibration: B =
+ * 3380 K and R0 = 10 kohm at T0 = 25 deg C; it gives C = 0 */
+#define CALIBRATION_BETA                    (3380.0)
+#define CALIBRATION_R0                      (10000.0)
+#define CALIBRATION_T0                      (298.15)
+
+/* Zero deg C in Kelvin, and in 0.01 Kelvin */
+#define CALIBRATION_ZERO_CELSIUS            (273.15)
+#define CALIBRATION_ZERO_CELSIUS_CENTI      (27315L)
+
+/* Newton iterations solving the Steinhart-Hart equation for ln(R); starting
+ * from the solution without the cubic term, three are enough for the
+ * coefficients of NTC thermistors */
+#define CALIBRATION_NEWTON_ITERATIONS       (4U)
+
+/* Smallest difference of ln(R) between two points, that is, about 1% of
+ * resistance or 0.3 deg C */
+#define CALIBRATION_MIN_LOG_STEP            (0.01)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Stored coefficients; the CRC covers the bytes before it */
+typedef struct
+{
+    uint32 magic;
+    calibration_coefficients_t coefficients;
+    uint16 crc;
+} calibration_record_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static bool calibration_build_table(const calibration_coefficients_t *coefficients, uint32 *table);
+static bool calibration_fit_thermistor(calibration_coefficients_t *coefficients, const uint32 *ratio,
+                                       const uint32 *reference, uint8 count);
+static bool calibration_fit_light(calibration_coefficients_t *coefficients, const int32 *counts,
+                                  const int32 *reference, uint8 count);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Row of the work flash holding the coefficients; see APP_WORK_FLASH_SECTION */
+APP_WORK_FLASH_SECTION CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+static uint8 calibration_storage[CY_FLASH_SIZEOF_ROW] = {0};
+
+/* Coefficients in use and their precomputed form: the ratio (Q16) at each
+ * temperature step of the thermistor table */
+static calibration_coefficients_t calibration_coefficients;
+static uint32 calibration_lut[THERMISTOR_LUT_ENTRIES];
+
+/* Points received from the host, replaced oldest first: thermistor ratios
+ * (Q16) with the reference temperatures in 0.01 Kelvin, and ALS counts with
+ * the expected percentages */
+static uint32 calibration_thermistor_ratio[CALIBRATION_THERMISTOR_POINTS];
+static uint32 calibration_thermistor_reference[CALIBRATION_THERMISTOR_POINTS];
+static uint8 calibration_thermistor_points = 0;
+static int32 calibration_light_counts[CALIBRATION_LIGHT_POINTS];
+static int32 calibration_light_reference[CALIBRATION_LIGHT_POINTS];
+static uint8 calibration_light_points = 0;
+
+
+/*******************************************************************************
+* Function Name: calibration_init
+********************************************************************************
+* Summary:
+* This function loads the coefficients stored in the flash. If no valid
+* coefficients are stored, the Beta model of the thermistor and the gain and
+* offset of the uncalibrated conversion are used.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void calibration_init(void)
+{
+    calibration_record_t record;
+    calibration_coefficients_t defaults;
+
+    memcpy(&record, calibration_storage, sizeof(record));
+
+    if((record.magic == CALIBRATION_MAGIC) &&
+       (record.crc == telemetry_crc16((const uint8 *)&record, offsetof(calibration_record_t, crc))) &&
+       calibration_apply(&record.coefficients))
+        return;
+
+    defaults.sh_b = 1.0 / CALIBRATION_BETA;
+    defaults.sh_a = (1.0 / CALIBRATION_T0) - (log(CALIBRATION_R0) * defaults.sh_b);
+    defaults.sh_c = 0.0;
+    defaults.als_gain = CALIBRATION_ALS_GAIN_DEFAULT;
+    defaults.als_offset = ALS_OFFSET;
+
+    if(!calibration_apply(&defaults))
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: calibration_apply
+********************************************************************************
+* Summary:
+* This function checks a set of coefficients and computes the thermistor table
+* from them. The table holds the ratio at each temperature step, as the table
+* generated from the Beta model, so the conversion of a reading is the same
+* binary search and interpolation. This takes floating point operations once,
+* not per reading.
+*
+* Parameters:
+*  coefficients: coefficients to be used
+*
+* Return:
+*  true if the coefficients are in use; false if they do not give a decreasing
+*  resistance over the table range or a positive ALS gain, in which case the
+*  coefficients in use are kept
+*
+*******************************************************************************/
+bool calibration_apply(const calibration_coefficients_t *coefficients)
+{
+    uint32 table[THERMISTOR_LUT_ENTRIES];
+
+    if(!isfinite(coefficients->sh_a) || !isfinite(coefficients->sh_b) || !isfinite(coefficients->sh_c) ||
+       (coefficients->sh_b <= 0.0) || (coefficients->als_gain <= 0))
+        return(false);
+
+    if(!calibration_build_table(coefficients, table))
+        return(false);
+
+    memcpy(calibration_lut, table, sizeof(calibration_lut));
+    calibration_coefficients = *coefficients;
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: calibration_get
+********************************************************************************
+* Summary:
+* This function returns the coefficients in use.
+*
+* Parameters:
+*  coefficients: receives the coefficients
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void calibration_get(calibration_coefficients_t *coefficients)
+{
+    *coefficients = calibration_coefficients;
+}
+
+/*******************************************************************************
+* Function Name: calibration_save
+********************************************************************************
+* Summary:
+* This function programs the coefficients in use into the flash row. This
+* blocks the CPU for the row erase and program, up to about 20 ms.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the row was programmed
+*
+*******************************************************************************/
+bool calibration_save(void)
+{
+    CY_ALIGN(4) static uint8 row[CY_FLASH_SIZEOF_ROW];
+    calibration_record_t record;
+    cyhal_flash_t flash;
+    cy_rslt_t result;
+
+    memset(&record, 0, sizeof(record));
+    record.magic = CALIBRATION_MAGIC;
+    record.coefficients = calibration_coefficients;
+    record.crc = telemetry_crc16((const uint8 *)&record, offsetof(calibration_record_t, crc));
+
+    memset(row, 0, sizeof(row));
+    memcpy(row, &record, sizeof(record));
+
+    if(cyhal_flash_init(&flash) != CY_RSLT_SUCCESS)
+        return(false);
+
+    result = cyhal_flash_write(&flash, (uint32)calibration_storage, (const uint32 *)row);
+    cyhal_flash_free(&flash);
+
+    return(result == CY_RSLT_SUCCESS);
+}
+
+/*******************************************************************************
+* Function Name: calibration_get_temperature
+********************************************************************************
+* Summary:
+* This function converts a ratio with the table of the device.
+*
+* Parameters:
+*  ratio_q16: thermistor count / reference count in Q16 format
+*
+* Return:
+*  temperature in 0.01 deg C
+*
+*******************************************************************************/
+int32 calibration_get_temperature(uint32 ratio_q16)
+{
+    return(thermistor_lut_interpolate(calibration_lut, ratio_q16));
+}
+
+/*******************************************************************************
+* Function Name: calibration_get_light_intensity
+********************************************************************************
+* Summary:
+* This function converts ALS counts with the gain and the offset of the
+* device.
+*
+* Parameters:
+*  adc_count: filtered ALS counts
+*
+* Return:
+*  ambient light intensity in percentage (0 - 100)
+*
+*******************************************************************************/
+uint8 calibration_get_light_intensity(int32 adc_count)
+{
+    int32 als_level;
+
+    if(adc_count < 0)
+        adc_count = 0;
+
+    als_level = (int32)(((int64_t)adc_count * calibration_coefficients.als_gain) >> CALIBRATION_ALS_GAIN_SHIFT) -
+                calibration_coefficients.als_offset;
+
+    /* Limit the values between 0 and 100 */
+    if(als_level > 100)
+        als_level = 100;
+
+    if(als_level < 0)
+        als_level = 0;
+
+    return((uint8)als_level);
+}
+
+/*******************************************************************************
+* Function Name: calibration_get_light_count
+********************************************************************************
+* Summary:
+* This function inverts the ALS conversion, for the thresholds compared with
+* raw results by the SAR range detection.
+*
+* Parameters:
+*  percent: light intensity in percentage
+*
+* Return:
+*  Lowest ALS count converted into percent or more
+*
+*******************************************************************************/
+uint32 calibration_get_light_count(int32 percent)
+{
+    int64_t level = (int64_t)percent + calibration_coefficients.als_offset;
+
+    if(level <= 0)
+        return(0);
+
+    return((uint32)(((level << CALIBRATION_ALS_GAIN_SHIFT) + calibration_coefficients.als_gain - 1) /
+                    calibration_coefficients.als_gain));
+}
+
+#if SENSING_CORE_TELEMETRY
+/*******************************************************************************
+* Function Name: calibration_receive_point
+********************************************************************************
+* Summary:
+* This function reads the reference value following CALIBRATION_THERMISTOR_
+* REQUEST or CALIBRATION_LIGHT_REQUEST from the host, adds a point at the
+* current filtered reading, fits the coefficients to the last points, and
+* stores them in the flash. The reading at each point after the fit is
+* printed. A point whose fit is rejected is discarded.
+*
+* Parameters:
+*  command: request character received
+*  filtered_data: filter output of each SAR channel
+*
+* Return:
+*  true if the coefficients were updated and stored
+*
+*******************************************************************************/
+bool calibration_receive_point(uint8 command, const int32 *filtered_data)
+{
+    const sensor_desc_t *sensor;
+    calibration_coefficients_t coefficients = calibration_coefficients;
+    uint32 thermistor_ratio[CALIBRATION_THERMISTOR_POINTS];
+    uint32 thermistor_reference[CALIBRATION_THERMISTOR_POINTS];
+    int32 light_counts[CALIBRATION_LIGHT_POINTS];
+    int32 light_reference[CALIBRATION_LIGHT_POINTS];
+    uint32 reference;
+    int32 therm_count;
+    int32 ref_count;
+    uint8 point;
+
+    if(!telemetry_read_decimal(&reference, CALIBRATION_REQUEST_CHAR_TIMEOUT_MS))
+        return(false);
+
+    if(command == CALIBRATION_THERMISTOR_REQUEST)
+    {
+        /* Take the counts as the conversion of the thermistor does */
+        sensor = &sensor_table[SENSOR_TEMPERATURE_INDEX];
+        therm_count = filtered_data[sensor->channel];
+        ref_count = filtered_data[sensor->ref_channel];
+
+        if(sensor->type == SENSOR_TYPE_THERMISTOR_RATIOMETRIC)
+        {
+            if(therm_count >= SENSOR_RATIOMETRIC_FULL_SCALE)
+                therm_count = SENSOR_RATIOMETRIC_FULL_SCALE - 1;
+
+            ref_count = SENSOR_RATIOMETRIC_FULL_SCALE - therm_count;
+        }
+
+        /* The new point goes last; the oldest point is dropped when full */
+        point = (calibration_thermistor_points < CALIBRATION_THERMISTOR_POINTS) ? calibration_thermistor_points :
+                (CALIBRATION_THERMISTOR_POINTS - 1U);
+        memcpy(thermistor_ratio, &calibration_thermistor_ratio[calibration_thermistor_points - point],
+               point * sizeof(uint32));
+        memcpy(thermistor_reference, &calibration_thermistor_reference[calibration_thermistor_points - point],
+               point * sizeof(uint32));
+        thermistor_ratio[point] = get_thermistor_ratio(therm_count, ref_count);
+        thermistor_reference[point] = reference;
+        point++;
+
+        if(!calibration_fit_thermistor(&coefficients, thermistor_ratio, thermistor_reference, point) ||
+           !calibration_apply(&coefficients))
+        {
+            printf("Calibration point rejected\r\n");
+            return(false);
+        }
+
+        memcpy(calibration_thermistor_ratio, thermistor_ratio, sizeof(thermistor_ratio));
+        memcpy(calibration_thermistor_reference, thermistor_reference, sizeof(thermistor_reference));
+        calibration_thermistor_points = point;
+
+        for(point = 0; point < calibration_thermistor_points; point++)
+        {
+            printf("Thermistor point %u: %ld -> %ld (0.01 deg C)\r\n", point + 1U,
+                   (long)calibration_thermistor_reference[point] - CALIBRATION_ZERO_CELSIUS_CENTI,
+                   (long)calibration_get_temperature(calibration_thermistor_ratio[point]));
+        }
+    }
+    else if(command == CALIBRATION_LIGHT_REQUEST)
+    {
+        sensor = &sensor_table[SENSOR_LIGHT_INDEX];
+
+        /* The new point goes last; the oldest point is dropped when full */
+        point = (calibration_light_points < CALIBRATION_LIGHT_POINTS) ? calibration_light_points :
+                (CALIBRATION_LIGHT_POINTS - 1U);
+        memcpy(light_counts, &calibration_light_counts[calibration_light_points - point], point * sizeof(int32));
+        memcpy(light_reference, &calibration_light_reference[calibration_light_points - point], point * sizeof(int32));
+        light_counts[point] = (filtered_data[sensor->channel] > 0) ? filtered_data[sensor->channel] : 0;
+        light_reference[point] = (int32)reference;
+        point++;
+
+        if(!calibration_fit_light(&coefficients, light_counts, light_reference, point) ||
+           !calibration_apply(&coefficients))
+        {
+            printf("Calibration point rejected\r\n");
+            return(false);
+        }
+
+        memcpy(calibration_light_counts, light_counts, sizeof(light_counts));
+        memcpy(calibration_light_reference, light_reference, sizeof(light_reference));
+        calibration_light_points = point;
+
+        printf("ALS gain: %ld/65536 per count  offset: %ld\r\n",
+               (long)calibration_coefficients.als_gain, (long)calibration_coefficients.als_offset);
+    }
+    else
+    {
+        return(false);
+    }
+
+    if(!calibration_save())
+    {
+        printf("Calibration not stored\r\n");
+        return(false);
+    }
+
+    return(true);
+}
+#endif
+
+/*******************************************************************************
+* Function Name: calibration_build_table
+********************************************************************************
+* Summary:
+* This function solves the Steinhart-Hart equation for the resistance at each
+* temperature step of the thermistor table with Newton's method, and converts
+* the resistances into ratios to the reference resistor.
+*
+* Parameters:
+*  coefficients: Steinhart-Hart coefficients
+*  table: array of THERMISTOR_LUT_ENTRIES entries to receive the ratios (Q16)
+*
+* Return:
+*  true if the ratios decrease over the table and fit the Q16 range
+*
+*******************************************************************************/
+static bool calibration_build_table(const calibration_coefficients_t *coefficients, uint32 *table)
+{
+    double inverse_t;
+    double log_r;
+    double ratio;
+    uint8 entry;
+    uint8 iteration;
+
+    for(entry = 0; entry < THERMISTOR_LUT_ENTRIES; entry++)
+    {
+        inverse_t = 1.0 / (CALIBRATION_ZERO_CELSIUS +
+                           ((THERMISTOR_LUT_T_MIN_CENTI + ((int32)entry * THERMISTOR_LUT_T_STEP_CENTI)) / 100.0));
+
+        log_r = (inverse_t - coefficients->sh_a) / coefficients->sh_b;
+
+        for(iteration = 0; iteration < CALIBRATION_NEWTON_ITERATIONS; iteration++)
+        {
+            log_r -= (coefficients->sh_a + (coefficients->sh_b * log_r) +
+                      (coefficients->sh_c * log_r * log_r * log_r) - inverse_t) /
+                     (coefficients->sh_b + (3.0 * coefficients->sh_c * log_r * log_r));
+        }
+
+        ratio = (exp(log_r) / CALIBRATION_R_REFERENCE) * (double)(1UL << THERMISTOR_LUT_RATIO_SHIFT);
+
+        if(!isfinite(ratio) || (ratio < 1.0) || (ratio >= (double)UINT32_MAX))
+            return(false);
+
+        table[entry] = (uint32)(ratio + 0.5);
+
+        if((entry > 0U) && (table[entry] >= table[entry - 1U]))
+            return(false);
+    }
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: calibration_fit_thermistor
+********************************************************************************
+* Summary:
+* This function fits the Steinhart-Hart coefficients to the thermistor points.
+* One point corrects A; two points correct A and B, keeping C; three points
+* give the exact solution of 1/T = A + B L + C L^3 with L = ln(R).
+*
+* Parameters:
+*  coefficients: coefficients to be corrected
+*  ratio: thermistor to reference ratio (Q16) of each point
+*  reference: reference temperature of each point in 0.01 Kelvin
+*  count: number of points, up to CALIBRATION_THERMISTOR_POINTS
+*
+* Return:
+*  true unless two points are too close to each other
+*
+*******************************************************************************/
+static bool calibration_fit_thermistor(calibration_coefficients_t *coefficients, const uint32 *ratio,
+                                       const uint32 *reference, uint8 count)
+{
+    double l[CALIBRATION_THERMISTOR_POINTS];
+    double y[CALIBRATION_THERMISTOR_POINTS];
+    double g2;
+    double g3;
+    uint8 point;
+    uint8 other;
+
+    for(point = 0; point < count; point++)
+    {
+        if((ratio[point] == 0U) || (ratio[point] == UINT32_MAX) || (reference[point] == 0U))
+            return(false);
+
+        l[point] = log(((double)ratio[point] * CALIBRATION_R_REFERENCE) / (double)(1UL << THERMISTOR_LUT_RATIO_SHIFT));
+        y[point] = 100.0 / (double)reference[point];
+
+        for(other = 0; other < point; other++)
+        {
+            if(fabs(l[point] - l[other]) < CALIBRATION_MIN_LOG_STEP)
+                return(false);
+        }
+    }
+
+    if(count == 3U)
+    {
+        g2 = (y[1] - y[0]) / (l[1] - l[0]);
+        g3 = (y[2] - y[0]) / (l[2] - l[0]);
+        coefficients->sh_c = ((g3 - g2) / (l[2] - l[1])) / (l[0] + l[1] + l[2]);
+        coefficients->sh_b = g2 - (coefficients->sh_c * ((l[0] * l[0]) + (l[0] * l[1]) + (l[1] * l[1])));
+    }
+    else if(count == 2U)
+    {
+        coefficients->sh_b = ((y[1] - (coefficients->sh_c * l[1] * l[1] * l[1])) -
+                              (y[0] - (coefficients->sh_c * l[0] * l[0] * l[0]))) / (l[1] - l[0]);
+    }
+
+    coefficients->sh_a = y[0] - (coefficients->sh_b * l[0]) - (coefficients->sh_c * l[0] * l[0] * l[0]);
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: calibration_fit_light
+********************************************************************************
+* Summary:
+* This function fits the ALS gain and offset to the light points. One point
+* corrects the offset; two points give the gain and the offset.
+*
+* Parameters:
+*  coefficients: coefficients to be corrected
+*  counts: filtered ALS counts of each point
+*  reference: expected percentage of each point
+*  count: number of points, up to CALIBRATION_LIGHT_POINTS
+*
+* Return:
+*  true unless the two points have the same counts or give a gain out of range
+*
+*******************************************************************************/
+static bool calibration_fit_light(calibration_coefficients_t *coefficients, const int32 *counts,
+                                  const int32 *reference, uint8 count)
+{
+    int64_t gain;
+
+    if(count == 2U)
+    {
+        if(counts[1] == counts[0])
+            return(false);
+
+        gain = ((int64_t)(reference[1] - reference[0]) << CALIBRATION_ALS_GAIN_SHIFT) / (counts[1] - counts[0]);
+
+        if((gain <= 0) || (gain > INT32_MAX))
+            return(false);
+
+        coefficients->als_gain = (int32)gain;
+    }
+
+    coefficients->als_offset = (int32)(((int64_t)counts[0] * coefficients->als_gain) >> CALIBRATION_ALS_GAIN_SHIFT) -
+                               reference[0];
+
+    return(true);
+}
+#endif /* ENABLE_CALIBRATION */
+
+/* [] END OF FILE */
@@ -0,0 +1,130 @@
+/******************************************************************************
+* File Name: calibration.h
+*
+* Description: This file contains the declarations of the per-device sensor
+*              calibration: Steinhart-Hart coefficients of the thermistor and
+*              gain and offset of the ambient light sensor, kept in the work flash.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CALIBRATION_H_
+#define CALIBRATION_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Character sent by the host to add a thermistor point at the current reading;
+ * it is followed by the reference temperature in 0.01 Kelvin and a carriage
+ * return, for example "K29815\r" at 25 deg C */
+#define CALIBRATION_THERMISTOR_REQUEST      ('K')
+
+/* Character sent by the host to add an ambient light point at the current
+ * reading; it is followed by the expected intensity in percentage and a
+ * carriage return, for example "L50\r" */
+#define CALIBRATION_LIGHT_REQUEST           ('L')
+
+/* Time allowed between the characters of a request in milliseconds */
+#define CALIBRATION_REQUEST_CHAR_TIMEOUT_MS (20U)
+
+/* Points used by the fits: the last three thermistor points give A, B and C,
+ * and the last two light points give the gain and the offset. Fewer points
+ * only correct the offset terms. */
+#define CALIBRATION_THERMISTOR_POINTS       (3U)
+#define CALIBRATION_LIGHT_POINTS            (2U)
+
+/* Fractional bits of the ALS gain */
+#define CALIBRATION_ALS_GAIN_SHIFT          (16U)
+
+/* ALS gain before calibration: 100 percent for 1024 counts, the shift of the
+ * uncalibrated get_light_intensity */
+#define CALIBRATION_ALS_GAIN_DEFAULT        ((int32)((100UL << CALIBRATION_ALS_GAIN_SHIFT) >> 10))
+
+/* Magic number of the stored coefficients, "CAL1" */
+#define CALIBRATION_MAGIC                   (0x314C4143UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Coefficients of one device */
+typedef struct
+{
+    /* Steinhart-Hart coefficients: 1/T = A + B ln(R) + C ln(R)^3, with T in
+     * Kelvin and R the thermistor resistance in ohm */
+    double sh_a;
+    double sh_b;
+    double sh_c;
+
+    /* Light intensity in percentage = ((count * als_gain) >>
+     * CALIBRATION_ALS_GAIN_SHIFT) - als_offset */
+    int32 als_gain;
+    int32 als_offset;
+} calibration_coefficients_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to load the coefficients of the device, or the defaults */
+void calibration_init(void);
+
+/* Function to check a set of coefficients and use it for the conversions */
+bool calibration_apply(const calibration_coefficients_t *coefficients);
+
+/* Function to get the coefficients in use */
+void calibration_get(calibration_coefficients_t *coefficients);
+
+/* Function to store the coefficients in use in the flash */
+bool calibration_save(void);
+
+/* Function to convert the ratio of thermistor to reference resistor counts
+ * (Q16) into temperature in 0.01 deg C */
+int32 calibration_get_temperature(uint32 ratio_q16);
+
+/* Function to convert the ALS counts into percentage */
+uint8 calibration_get_light_intensity(int32 adc_count);
+
+/* Function to get the lowest ALS count giving at least the given percentage */
+uint32 calibration_get_light_count(int32 percent);
+
+/* Function to read a calibration point from the host and fit the coefficients */
+bool calibration_receive_point(uint8 command, const int32 *filtered_data);
+
+#endif /* CALIBRATION_H_ */
+
+/* [] END OF FILE */
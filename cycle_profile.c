@@ -0,0 +1,225 @@
+/******************************************************************************
+* File Name: cycle_profile.c
+*
+* Description: This file contains the cycle counter instrumentation. The DWT cycle
+*              counter of the CPU is sampled at the start and the end of each phase
+*              and the running minimum, maximum, mean and a log2 histogram are kept.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "cycle_profile.h"
+
+#if ENABLE_CYCLE_PROFILE
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Statistics and start time of each phase */
+static cycle_profile_stats_t cycle_profile_stats[CYCLE_PROFILE_PHASES];
+static uint32 cycle_profile_start_time[CYCLE_PROFILE_PHASES];
+
+/* Names printed in the report */
+static const char * const cycle_profile_name[CYCLE_PROFILE_PHASES] =
+{
+    "Wake (total)",
+    "FIFO drain",
+    "Filter",
+    "Conversion",
+    "UART poll"
+};
+
+
+/*******************************************************************************
+* Function Name: cycle_profile_init
+********************************************************************************
+* Summary:
+* This function enables the DWT cycle counter and clears the statistics. The
+* counter runs with the CPU clock and stops in Sleep and Deep Sleep modes, so
+* only active cycles are counted.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void cycle_profile_init(void)
+{
+    uint8 phase;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    for(phase = 0; phase < CYCLE_PROFILE_PHASES; phase++)
+    {
+        memset(&cycle_profile_stats[phase], 0, sizeof(cycle_profile_stats_t));
+        cycle_profile_stats[phase].min = UINT32_MAX;
+    }
+}
+
+/*******************************************************************************
+* Function Name: cycle_profile_start
+********************************************************************************
+* Summary:
+* This function marks the start of a phase.
+*
+* Parameters:
+*  phase: phase being started
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void cycle_profile_start(cycle_profile_phase_t phase)
+{
+    cycle_profile_start_time[phase] = DWT->CYCCNT;
+}
+
+/*******************************************************************************
+* Function Name: cycle_profile_stop
+********************************************************************************
+* Summary:
+* This function marks the end of a phase and adds its duration to the
+* statistics of the phase.
+*
+* Parameters:
+*  phase: phase being ended
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void cycle_profile_stop(cycle_profile_phase_t phase)
+{
+    cycle_profile_stats_t *stats = &cycle_profile_stats[phase];
+    uint32 cycles = DWT->CYCCNT - cycle_profile_start_time[phase];
+    uint32 bin;
+
+    if(cycles < stats->min)
+        stats->min = cycles;
+
+    if(cycles > stats->max)
+        stats->max = cycles;
+
+    stats->sum += cycles;
+    stats->count++;
+
+    /* Bin is the position of the highest set bit */
+    bin = (cycles == 0) ? 0 : (31UL - __CLZ(cycles));
+
+    if(bin >= CYCLE_PROFILE_BINS)
+        bin = CYCLE_PROFILE_BINS - 1;
+
+    stats->histogram[bin]++;
+}
+
+/*******************************************************************************
+* Function Name: cycle_profile_get_stats
+********************************************************************************
+* Summary:
+* This function returns a copy of the statistics of a phase.
+*
+* Parameters:
+*  phase: phase of interest
+*  stats: structure to be filled
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void cycle_profile_get_stats(cycle_profile_phase_t phase, cycle_profile_stats_t *stats)
+{
+    uint32 interrupt_state;
+
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    *stats = cycle_profile_stats[phase];
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+/*******************************************************************************
+* Function Name: cycle_profile_report
+********************************************************************************
+* Summary:
+* This function prints the minimum, maximum and mean cycle count of each phase
+* followed by the non-empty histogram bins. It uses blocking printf and is
+* meant to be called on request only.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void cycle_profile_report(void)
+{
+    cycle_profile_stats_t stats;
+    uint8 phase;
+    uint8 bin;
+
+    printf("\r\nPhase           Count       Min       Max      Mean  (cycles at %lu Hz)\r\n",
+           (unsigned long)SystemCoreClock);
+
+    for(phase = 0; phase < CYCLE_PROFILE_PHASES; phase++)
+    {
+        cycle_profile_get_stats((cycle_profile_phase_t)phase, &stats);
+
+        if(stats.count == 0)
+        {
+            printf("%-12s  %7lu         -         -         -\r\n", cycle_profile_name[phase], 0UL);
+            continue;
+        }
+
+        printf("%-12s  %7lu %9lu %9lu %9lu\r\n", cycle_profile_name[phase], (unsigned long)stats.count,
+               (unsigned long)stats.min, (unsigned long)stats.max,
+               (unsigned long)(stats.sum / stats.count));
+
+        for(bin = 0; bin < CYCLE_PROFILE_BINS; bin++)
+        {
+            if(stats.histogram[bin] != 0)
+                printf("    >= %7lu: %lu\r\n", (unsigned long)(1UL << bin), (unsigned long)stats.histogram[bin]);
+        }
+    }
+}
+
+#endif /* ENABLE_CYCLE_PROFILE */
+
+/* [] END OF FILE */
@@ -0,0 +1,111 @@
+/******************************************************************************
+* File Name: cycle_profile.h
+*
+* Description: This file contains the interface of the cycle counter instrumentation
+*              of the wake-process-sleep cycle.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYCLE_PROFILE_H_
+#define CYCLE_PROFILE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of histogram bins; bin n counts the durations of 2^n to 2^(n+1) - 1
+ * cycles, the last bin also counts all longer durations */
+#define CYCLE_PROFILE_BINS                  (20)
+
+/* Character sent by the host to request the report */
+#define CYCLE_PROFILE_REPORT_REQUEST        ('P')
+
+/* Instrumentation macros; compiled out when ENABLE_CYCLE_PROFILE is 0 */
+#if ENABLE_CYCLE_PROFILE
+#define CYCLE_PROFILE_START(phase)          cycle_profile_start(phase)
+#define CYCLE_PROFILE_STOP(phase)           cycle_profile_stop(phase)
+#else
+#define CYCLE_PROFILE_START(phase)
+#define CYCLE_PROFILE_STOP(phase)
+#endif
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Phases of the wake-process-sleep cycle */
+typedef enum
+{
+    CYCLE_PROFILE_WAKE,             /* From wake-up to the next sleep request */
+    CYCLE_PROFILE_FIFO_DRAIN,       /* FIFO read loop */
+    CYCLE_PROFILE_FILTER,           /* IIR filter bank */
+    CYCLE_PROFILE_CONVERSION,       /* sensor_table_convert */
+    CYCLE_PROFILE_UART_WAIT,        /* UART polled before deep sleep; only without ENABLE_ASYNC_TELEMETRY,
+                                     * as the counter stops in CPU Sleep */
+    CYCLE_PROFILE_PHASES
+} cycle_profile_phase_t;
+
+/* Statistics of a phase */
+typedef struct
+{
+    uint32 min;
+    uint32 max;
+    uint64_t sum;
+    uint32 count;
+    uint32 histogram[CYCLE_PROFILE_BINS];
+} cycle_profile_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to enable the cycle counter and clear the statistics */
+void cycle_profile_init(void);
+
+/* Functions to mark the start and the end of a phase */
+void cycle_profile_start(cycle_profile_phase_t phase);
+void cycle_profile_stop(cycle_profile_phase_t phase);
+
+/* Function to get the statistics of a phase */
+void cycle_profile_get_stats(cycle_profile_phase_t phase, cycle_profile_stats_t *stats);
+
+/* Function to print the statistics of all phases */
+void cycle_profile_report(void);
+
+#endif /* CYCLE_PROFILE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,280 @@
+/******************************************************************************
+* File Name: excitation.c
+*
+* Description: This file contains the scan windows. A low-power timer starts
+*              a window every EXCITATION_PERIOD_MS: the divider supplies are
+*              switched on (excitation gating) and the SAR, AREF and LPOSC are
+*              enabled (burst mode), and after the settling time the PASS timer
+*              starts the scans. The FIFO level interrupt of the last scan of
+*              the window stops the PASS timer and switches the supplies off,
+*              so the dividers draw current only for the settling time and the
+*              scans of the window. In burst mode, the analog blocks are
+*              disabled again once the FIFO is read.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "excitation.h"
+#include "filter_bank.h"
+
+#if ENABLE_SCAN_WINDOWS
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of divider supplies */
+#define EXCITATION_PIN_COUNT                (2U)
+
+/* Priority of the window timer interrupt */
+#define EXCITATION_TIMER_PRIORITY           (7U)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void excitation_set(bool on);
+static void excitation_timer_callback(void *callback_arg, cyhal_lptimer_event_t event);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Divider supplies */
+static const cyhal_gpio_t excitation_pins[EXCITATION_PIN_COUNT] =
+{
+#if ENABLE_EXCITATION_GATING
+    EXCITATION_THERMISTOR_PIN,
+    EXCITATION_ALS_PIN
+#else
+    NC,
+    NC
+#endif
+};
+
+/* Low-power timer (MCWDT) starting the windows; it runs in System Deep Sleep */
+static cyhal_lptimer_t excitation_timer;
+
+/* Set while the dividers settle before the scans of the window */
+static bool excitation_settling = false;
+
+
+/*******************************************************************************
+* Function Name: excitation_init
+********************************************************************************
+* Summary:
+* This function drives the divider supplies low, sets the FIFO level to the
+* entries of one window, retunes the filters to the rate of the windows, and
+* starts the window timer. The PASS timer must not be enabled by the caller.
+* In burst mode, the hardware averaging is disabled so that a scan fits in
+* the burst timer period, and the analog blocks are disabled till the first
+* burst; the filters are not used.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void excitation_init(void)
+{
+    uint8 index;
+    uint8 channel;
+
+    for(index = 0; index < EXCITATION_PIN_COUNT; index++)
+    {
+        if(excitation_pins[index] != NC)
+        {
+            cyhal_gpio_configure(excitation_pins[index], CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG);
+            cyhal_gpio_write(excitation_pins[index], false);
+        }
+    }
+
+    /* The level interrupt marks the end of the window */
+    APP_SAR_FIFO_LEVEL = EXCITATION_WINDOW_ENTRIES - 1UL;
+
+    Cy_SysAnalog_TimerSetPeriod(PASS, EXCITATION_TIMER_PERIOD);
+
+    for(channel = 0; channel < FILTER_BANK_CHANNELS; channel++)
+    {
+        if((SAR_SCAN_CHANNEL_MASK & (1UL << channel)) == 0UL)
+            continue;
+
+#if ENABLE_BURST_MODE
+        /* The mean of the burst replaces the hardware averaging */
+        CY_REG32_CLR_SET(SAR_CHAN_CONFIG(SAR0, channel), SAR_CHAN_CONFIG_AVG_EN, 0UL);
+#else
+        /* Keep the cut-off frequencies with EXCITATION_SCANS samples per
+         * window period */
+        filter_bank_retune(channel, EXCITATION_RATE_DIVIDER, 0U);
+#endif
+    }
+
+#if ENABLE_BURST_MODE
+    excitation_power_down();
+#endif
+
+    if(cyhal_lptimer_init(&excitation_timer) != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    cyhal_lptimer_register_callback(&excitation_timer, excitation_timer_callback, NULL);
+    cyhal_lptimer_enable_event(&excitation_timer, CYHAL_LPTIMER_COMPARE_MATCH, EXCITATION_TIMER_PRIORITY, true);
+
+    if(cyhal_lptimer_set_delay(&excitation_timer, EXCITATION_WINDOW_PERIOD_TICKS) != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: excitation_end_window
+********************************************************************************
+* Summary:
+* This function stops the scans and switches the divider supplies off. It is
+* called from the FIFO level interrupt, which is raised by the last scan of
+* the window.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void excitation_end_window(void)
+{
+    Cy_SysAnalog_TimerDisable(PASS);
+    excitation_set(false);
+}
+
+/*******************************************************************************
+* Function Name: excitation_power_down
+********************************************************************************
+* Summary:
+* This function disables the SAR, AREF and LPOSC between two bursts. It is
+* called once the FIFO entries of the burst are read; the configuration of
+* the blocks is kept, so the next window only enables them.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void excitation_power_down(void)
+{
+    Cy_SAR_Disable(SAR0);
+    Cy_SysAnalog_LpOscDisable(PASS);
+    Cy_SysAnalog_Disable();
+}
+
+/*******************************************************************************
+* Function Name: excitation_set
+********************************************************************************
+* Summary:
+* This function drives all the divider supplies.
+*
+* Parameters:
+*  on: true to supply the dividers
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void excitation_set(bool on)
+{
+    uint8 index;
+
+    for(index = 0; index < EXCITATION_PIN_COUNT; index++)
+    {
+        if(excitation_pins[index] != NC)
+            cyhal_gpio_write(excitation_pins[index], on);
+    }
+}
+
+/*******************************************************************************
+* Function Name: excitation_timer_callback
+********************************************************************************
+* Summary:
+* This function starts a window in two timer matches, so that the CPU sleeps
+* during the settling time. The first match supplies the dividers, enables the
+* analog blocks in burst mode, and schedules the second match after
+* EXCITATION_SETTLING_TICKS. The second match enables the PASS timer, which
+* triggers the first scan at the end of its first period, and schedules the
+* next window for the rest of the window period. Each match is scheduled first,
+* so the handling time does not add to the delays.
+*
+* Parameters:
+*  callback_arg: not used
+*  event: not used
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void excitation_timer_callback(void *callback_arg, cyhal_lptimer_event_t event)
+{
+    (void)callback_arg;
+    (void)event;
+
+    if(!excitation_settling)
+    {
+        /* Settling of the dividers and, in burst mode, start-up of AREF */
+        (void)cyhal_lptimer_set_delay(&excitation_timer, EXCITATION_SETTLING_TICKS);
+        excitation_settling = true;
+
+        excitation_set(true);
+
+#if ENABLE_BURST_MODE
+        /* Same order as init_analog_resources */
+        Cy_SysAnalog_Enable();
+        Cy_SysAnalog_LpOscEnable(PASS);
+        Cy_SAR_Enable(SAR0);
+#endif
+    }
+    else
+    {
+        (void)cyhal_lptimer_set_delay(&excitation_timer, EXCITATION_WINDOW_PERIOD_TICKS - EXCITATION_SETTLING_TICKS);
+        excitation_settling = false;
+
+        Cy_SysAnalog_TimerEnable(PASS);
+    }
+}
+
+#endif /* ENABLE_SCAN_WINDOWS */
+
+/* [] END OF FILE */
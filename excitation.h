@@ -0,0 +1,107 @@
+/******************************************************************************
+* File Name: excitation.h
+*
+* Description: This file contains the declarations of the scan windows: the
+*              excitation gating of the sensor dividers and the burst mode.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef EXCITATION_H_
+#define EXCITATION_H_
+
+#include "cy_pdl.h"
+#include "cyhal.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* GPIOs supplying the thermistor and the ALS dividers; NC if the divider is
+ * supplied continuously */
+#ifndef EXCITATION_THERMISTOR_PIN
+#define EXCITATION_THERMISTOR_PIN           (P10_3)
+#endif
+
+#ifndef EXCITATION_ALS_PIN
+#define EXCITATION_ALS_PIN                  (NC)
+#endif
+
+/* Scans per window, window period and PASS timer period within a window */
+#if ENABLE_BURST_MODE
+#define EXCITATION_SCANS                    (BURST_SCANS)
+#define EXCITATION_PERIOD_MS                (BURST_PERIOD_MS)
+#define EXCITATION_TIMER_PERIOD             (BURST_TIMER_PERIOD)
+#else
+#define EXCITATION_SCANS                    (EXCITATION_WINDOW_SCANS)
+#define EXCITATION_PERIOD_MS                (EXCITATION_WINDOW_PERIOD_MS)
+#define EXCITATION_TIMER_PERIOD             (SAR_TIMER_PERIOD)
+#endif
+
+/* FIFO entries collected in one window */
+#define EXCITATION_WINDOW_ENTRIES           (EXCITATION_SCANS * CHANNEL_COUNT)
+
+/* Window period in low-power timer (LFCLK) cycles */
+#define EXCITATION_WINDOW_PERIOD_TICKS      ((EXCITATION_PERIOD_MS * SAR_TIMER_CLOCK_HZ) / 1000UL)
+
+/* Settling time in low-power timer cycles, rounded up */
+#define EXCITATION_SETTLING_TICKS           (((EXCITATION_SETTLING_US * SAR_TIMER_CLOCK_HZ) + 999999UL) / 1000000UL)
+
+#if EXCITATION_SETTLING_TICKS >= EXCITATION_WINDOW_PERIOD_TICKS
+#error "EXCITATION_SETTLING_US must be shorter than the window period"
+#endif
+
+/* Sample rate of the filters (400 sps) divided by the rate of the windows */
+#define EXCITATION_RATE_DIVIDER             (((SAR_TIMER_CLOCK_HZ * EXCITATION_PERIOD_MS) + \
+                                              ((SAR_TIMER_PERIOD * 1000UL * EXCITATION_SCANS) / 2UL)) / \
+                                             (SAR_TIMER_PERIOD * 1000UL * EXCITATION_SCANS))
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to switch the dividers off, retune the filters and start the
+ * window timer */
+void excitation_init(void);
+
+/* Function to end the window; called from the FIFO level interrupt */
+void excitation_end_window(void);
+
+/* Function to disable the SAR, AREF and LPOSC once the FIFO is read */
+void excitation_power_down(void);
+
+#endif /* EXCITATION_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,268 @@
+/******************************************************************************
+* File Name: fifo_capture.c
+*
+* Description: This file contains the raw FIFO capture. The entries are packed
+*              into one of two frame buffers by the FIFO read loop; a full buffer
+*              is sent by the asynchronous UART transfer while the other one is
+*              filled, so the FIFO read loop never waits for the UART.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "fifo_capture.h"
+#include "telemetry.h"
+#include "pipeline.h"
+
+#if ENABLE_FIFO_CAPTURE
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Frame being filled and frame being sent */
+static uint8 fifo_capture_frames[2][FIFO_CAPTURE_FRAME_SIZE];
+static uint8 fifo_capture_fill = 0;
+
+/* Sequence number of the next frame */
+static uint16 fifo_capture_sequence = 0;
+
+/* Entries dropped since the last frame sent; the host adds up the counts of
+ * the frame headers */
+static uint32 fifo_capture_dropped = 0;
+
+/* State of the frame being filled */
+fifo_capture_state_t fifo_capture = { NULL, 0 };
+
+
+/*******************************************************************************
+* Function Name: fifo_capture_init
+********************************************************************************
+* Summary:
+* This function stops the capture and clears the sequence number and the drop
+* counters.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_capture_init(void)
+{
+    fifo_capture.frame = NULL;
+    fifo_capture.count = 0;
+    fifo_capture_sequence = 0;
+    fifo_capture_dropped = 0;
+}
+
+/*******************************************************************************
+* Function Name: fifo_capture_start
+********************************************************************************
+* Summary:
+* This function starts the capture with the next FIFO entry read.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_capture_start(void)
+{
+    if(fifo_capture.frame == NULL)
+    {
+        fifo_capture.count = 0;
+        fifo_capture.frame = fifo_capture_frames[fifo_capture_fill];
+    }
+}
+
+/*******************************************************************************
+* Function Name: fifo_capture_stop
+********************************************************************************
+* Summary:
+* This function sends the entries collected so far and stops the capture.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_capture_stop(void)
+{
+    fifo_capture_send();
+    fifo_capture.frame = NULL;
+}
+
+/*******************************************************************************
+* Function Name: fifo_capture_is_active
+********************************************************************************
+* Summary:
+* This function checks whether the capture is running.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the FIFO entries are captured
+*
+*******************************************************************************/
+bool fifo_capture_is_active(void)
+{
+    return(fifo_capture.frame != NULL);
+}
+
+/*******************************************************************************
+* Function Name: fifo_capture_send
+********************************************************************************
+* Summary:
+* This function completes the header and the CRC of the frame being filled and
+* starts its transfer, then fills the other frame. If the previous frame is
+* still being sent, the entries are dropped and counted; the count is sent in
+* the header of the next frame.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_capture_send(void)
+{
+    uint8 *frame = fifo_capture.frame;
+    uint16 length;
+    uint16 dropped;
+    uint16 crc;
+
+    if((frame == NULL) || (fifo_capture.count == 0U))
+        return;
+
+    length = (uint16)(FIFO_CAPTURE_HEADER_SIZE + (2U * fifo_capture.count));
+    dropped = (fifo_capture_dropped > 0xFFFFUL) ? 0xFFFFU : (uint16)fifo_capture_dropped;
+
+    frame[0] = FIFO_CAPTURE_SYNC;
+    frame[1] = (uint8)fifo_capture_sequence;
+    frame[2] = (uint8)(fifo_capture_sequence >> 8);
+    frame[3] = (uint8)dropped;
+    frame[4] = (uint8)(dropped >> 8);
+    frame[5] = (uint8)fifo_capture.count;
+    frame[6] = (uint8)(fifo_capture.count >> 8);
+
+    crc = telemetry_crc16(frame, length);
+    frame[length] = (uint8)crc;
+    frame[length + 1U] = (uint8)(crc >> 8);
+
+    if(telemetry_write_buffer(frame, length + FIFO_CAPTURE_CRC_SIZE))
+    {
+        fifo_capture_sequence++;
+        fifo_capture_dropped = 0;
+
+        /* The other frame was sent before this transfer could start */
+        fifo_capture_fill ^= 1U;
+        fifo_capture.frame = fifo_capture_frames[fifo_capture_fill];
+    }
+    else
+    {
+        fifo_capture_dropped += fifo_capture.count;
+    }
+
+    fifo_capture.count = 0;
+}
+#endif /* ENABLE_FIFO_CAPTURE */
+
+/*******************************************************************************
+* Function Name: fifo_capture_unpack
+********************************************************************************
+* Summary:
+* This function checks a received frame and converts its entries into raw FIFO
+* entries for pipeline_replay. The results are sign-extended from 12 bits, as
+* all the channels are signed. It does not depend on the capture being built in.
+*
+* Parameters:
+*  frame: received frame, from the sync byte to the CRC
+*  length: number of bytes of the frame
+*  fifo_entries: array of FIFO_CAPTURE_MAX_ENTRIES entries to receive the raw
+*                FIFO entries (PIPELINE_FIFO_ENTRY)
+*  count: number of entries written
+*
+* Return:
+*  true if the frame is complete and its CRC matches
+*
+*******************************************************************************/
+bool fifo_capture_unpack(const uint8 *frame, uint16 length, uint32 *fifo_entries, uint16 *count)
+{
+    uint16 entries;
+    uint16 packed;
+    uint16 crc;
+    uint8 channel;
+    int16 value;
+    uint16 i;
+
+    if((length < (FIFO_CAPTURE_HEADER_SIZE + FIFO_CAPTURE_CRC_SIZE)) || (frame[0] != FIFO_CAPTURE_SYNC))
+        return(false);
+
+    entries = (uint16)(frame[5] | ((uint16)frame[6] << 8));
+
+    if((entries > FIFO_CAPTURE_MAX_ENTRIES) ||
+       (length != (FIFO_CAPTURE_HEADER_SIZE + (2U * entries) + FIFO_CAPTURE_CRC_SIZE)))
+        return(false);
+
+    crc = (uint16)(frame[length - 2U] | ((uint16)frame[length - 1U] << 8));
+
+    if(telemetry_crc16(frame, length - FIFO_CAPTURE_CRC_SIZE) != crc)
+        return(false);
+
+    for(i = 0; i < entries; i++)
+    {
+        packed = (uint16)(frame[FIFO_CAPTURE_HEADER_SIZE + (2U * i)] |
+                          ((uint16)frame[FIFO_CAPTURE_HEADER_SIZE + (2U * i) + 1U] << 8));
+        channel = (uint8)((packed & FIFO_CAPTURE_CHANNEL_Msk) >> FIFO_CAPTURE_CHANNEL_Pos);
+        value = (int16)(packed & FIFO_CAPTURE_VALUE_Msk);
+
+        if((value & 0x0800) != 0)
+            value = (int16)(value - 0x1000);
+
+        fifo_entries[i] = PIPELINE_FIFO_ENTRY(channel, (uint16)value);
+    }
+
+    *count = entries;
+
+    return(true);
+}
+
+/* [] END OF FILE */
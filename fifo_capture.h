@@ -0,0 +1,156 @@
+/******************************************************************************
+* File Name: fifo_capture.h
+*
+* Description: This file contains the declarations of the raw FIFO capture: the
+*              FIFO entries read at each wake-up are packed as 12-bit results
+*              with a channel tag and sent over the UART in CRC-checked frames.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef FIFO_CAPTURE_H_
+#define FIFO_CAPTURE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+#if ENABLE_FIFO_DMA
+#include "fifo_dma.h"
+#endif
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Character sent by the host to start and stop the capture */
+#define FIFO_CAPTURE_TOGGLE_REQUEST         ('C')
+
+/* Frame header: sync, sequence (2), dropped entries (2), entry count (2);
+ * trailer: CRC (2) */
+#define FIFO_CAPTURE_SYNC                   (0x5AU)
+#define FIFO_CAPTURE_HEADER_SIZE            (7U)
+#define FIFO_CAPTURE_CRC_SIZE               (2U)
+
+/* Entries per frame; one frame holds the entries of one wake-up */
+#ifndef FIFO_CAPTURE_MAX_ENTRIES
+#if ENABLE_FIFO_DMA
+#define FIFO_CAPTURE_MAX_ENTRIES            (FIFO_DMA_BUFFER_ENTRIES)
+#else
+#define FIFO_CAPTURE_MAX_ENTRIES            (240U)
+#endif
+#endif
+
+#define FIFO_CAPTURE_FRAME_SIZE             (FIFO_CAPTURE_HEADER_SIZE + (2U * FIFO_CAPTURE_MAX_ENTRIES) + FIFO_CAPTURE_CRC_SIZE)
+
+/* Fields of a packed entry: 12-bit result in two's complement, and the
+ * channel. design.modus sets both the differential and the single-ended
+ * result formats to signed, so every channel is sign-extended on unpacking. */
+#define FIFO_CAPTURE_VALUE_Msk              (0x0FFFU)
+#define FIFO_CAPTURE_CHANNEL_Pos            (12U)
+#define FIFO_CAPTURE_CHANNEL_Msk            (0xF000U)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* State of the frame being filled */
+typedef struct
+{
+    /* Frame being filled; NULL while the capture is stopped */
+    uint8 *frame;
+
+    /* Number of entries in the frame */
+    uint16 count;
+} fifo_capture_state_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+extern fifo_capture_state_t fifo_capture;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to stop the capture and clear the counters */
+void fifo_capture_init(void);
+
+/* Functions to start and stop the capture */
+void fifo_capture_start(void);
+void fifo_capture_stop(void);
+
+/* Function to check whether the capture is running */
+bool fifo_capture_is_active(void);
+
+/* Function to send the entries collected since the last call */
+void fifo_capture_send(void);
+
+/* Function to convert a received frame into raw FIFO entries for replay */
+bool fifo_capture_unpack(const uint8 *frame, uint16 length, uint32 *fifo_entries, uint16 *count);
+
+/*******************************************************************************
+* Function Name: fifo_capture_add
+********************************************************************************
+* Summary:
+* This function packs a FIFO entry into the frame being filled. The frame is
+* sent when it is full; the remaining entries are sent by
+* fifo_capture_send.
+*
+* Parameters:
+*  channel: SAR channel of the entry
+*  value: ADC result
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+__STATIC_INLINE void fifo_capture_add(uint8 channel, uint16 value)
+{
+    uint8 *entry;
+    uint16 packed;
+
+    if(fifo_capture.frame == NULL)
+        return;
+
+    packed = (uint16)(((uint16)channel << FIFO_CAPTURE_CHANNEL_Pos) | (value & FIFO_CAPTURE_VALUE_Msk));
+    entry = &fifo_capture.frame[FIFO_CAPTURE_HEADER_SIZE + (2U * fifo_capture.count)];
+    entry[0] = (uint8)packed;
+    entry[1] = (uint8)(packed >> 8);
+
+    if(++fifo_capture.count == FIFO_CAPTURE_MAX_ENTRIES)
+        fifo_capture_send();
+}
+
+#endif /* FIFO_CAPTURE_H_ */
+
+/* [] END OF FILE */
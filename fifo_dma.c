@@ -0,0 +1,350 @@
+/******************************************************************************
+* File Name: fifo_dma.c
+*
+* Description: This file contains the DMA based SAR FIFO drain. A DataWire channel
+*              moves each FIFO level worth of entries into a double buffered RAM
+*              ring and interrupts the CPU only when one half of the ring is full.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "fifo_dma.h"
+
+#if ENABLE_FIFO_DMA
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Fields of the FIFO read data register */
+#define FIFO_DMA_RESULT_MASK                (0x0000FFFFUL)
+#define FIFO_DMA_CHAN_ID_POS                (16UL)
+#define FIFO_DMA_CHAN_ID_MASK               (0x000F0000UL)
+
+/* Number of halves in the ring */
+#define FIFO_DMA_BUFFER_COUNT               (2)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* DataWire channel interrupt handler */
+static void fifo_dma_interrupt_handler(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Double buffered RAM ring filled by the DataWire channel */
+static uint32 fifo_dma_buffer[FIFO_DMA_BUFFER_COUNT][FIFO_DMA_BUFFER_ENTRIES];
+
+/* One descriptor per half of the ring; each one chains to the other */
+static cy_stc_dma_descriptor_t fifo_dma_descriptor[FIFO_DMA_BUFFER_COUNT];
+
+/* Copy of the SAR configuration with the FIFO trigger output enabled */
+static cy_stc_sar_config_t fifo_dma_sar_config;
+static cy_stc_sar_fifo_config_t fifo_dma_fifo_config;
+
+/* Bit mask of the halves which are full and not yet processed */
+static volatile uint8 fifo_dma_full_mask = 0;
+
+/* Half that the DataWire channel is currently filling */
+static volatile uint8 fifo_dma_write_half = 0;
+
+/* Half and entry that is read next by the CPU */
+static uint8 fifo_dma_read_half = 0;
+static uint16 fifo_dma_read_index = 0;
+
+/* Number of halves overwritten before being processed */
+static volatile uint32 fifo_dma_overrun_count = 0;
+
+/* DataWire interrupt configuration structure */
+static const cy_stc_sysint_t fifo_dma_irq_cfg = {
+    .intrSrc = APP_INTR_SRC(FIFO_DMA_IRQ, FIFO_DMA_IRQ_CM0P_LINE),
+    .intrPriority = 7
+};
+
+
+/*******************************************************************************
+* Function Name: fifo_dma_get_sar_config
+********************************************************************************
+* Summary:
+* This function returns a copy of the SAR configuration generated by the device
+* configurator with the FIFO level trigger output enabled. The trigger output is
+* used to request the DataWire transfer.
+*
+* Parameters:
+*  sar_config: SAR configuration generated by the device configurator
+*
+* Return:
+*  SAR configuration to be passed to Cy_SAR_Init
+*
+*******************************************************************************/
+const cy_stc_sar_config_t * fifo_dma_get_sar_config(const cy_stc_sar_config_t * sar_config)
+{
+    fifo_dma_sar_config = *sar_config;
+    fifo_dma_fifo_config = *sar_config->fifoCfgPtr;
+
+    /* Generate a trigger every time the FIFO reaches the level */
+    fifo_dma_fifo_config.trOut = true;
+    fifo_dma_sar_config.fifoCfgPtr = &fifo_dma_fifo_config;
+
+    return(&fifo_dma_sar_config);
+}
+
+/*******************************************************************************
+* Function Name: fifo_dma_init
+********************************************************************************
+* Summary:
+* This function initializes the DataWire channel which moves the data from the
+* SAR FIFO to the RAM ring. It must be called before any HAL driver allocates a
+* DMA channel. Each descriptor performs FIFO_DMA_LEVELS_PER_BUFFER
+* X loops of SAR_FIFO_LEVEL words; one X loop is executed per FIFO trigger.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_dma_init(void)
+{
+    cy_stc_dma_descriptor_config_t descriptor_config;
+    cy_stc_dma_channel_config_t channel_config;
+    uint8 half;
+
+    /* Reserve the channel so that the HAL does not allocate it for the UART */
+    const cyhal_resource_inst_t channel_resource =
+    {
+        .type = CYHAL_RSC_DW,
+        .block_num = 0,
+        .channel_num = FIFO_DMA_CHANNEL
+    };
+
+    if (cyhal_hwmgr_reserve(&channel_resource) != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    descriptor_config.retrigger = CY_DMA_RETRIG_4CYC;
+    descriptor_config.interruptType = CY_DMA_DESCR;
+    descriptor_config.triggerOutType = CY_DMA_DESCR;
+    descriptor_config.channelState = CY_DMA_CHANNEL_ENABLED;
+    descriptor_config.triggerInType = CY_DMA_X_LOOP;
+    descriptor_config.dataSize = CY_DMA_WORD;
+    descriptor_config.srcTransferSize = CY_DMA_TRANSFER_SIZE_DATA;
+    descriptor_config.dstTransferSize = CY_DMA_TRANSFER_SIZE_DATA;
+    descriptor_config.descriptorType = CY_DMA_2D_TRANSFER;
+    descriptor_config.srcAddress = (void *) &APP_SAR_FIFO_RD_DATA;
+    descriptor_config.srcXincrement = 0;
+    descriptor_config.dstXincrement = 1;
+    descriptor_config.xCount = SAR_FIFO_LEVEL;
+    descriptor_config.srcYincrement = 0;
+    descriptor_config.dstYincrement = SAR_FIFO_LEVEL;
+    descriptor_config.yCount = FIFO_DMA_LEVELS_PER_BUFFER;
+
+    for(half = 0; half < FIFO_DMA_BUFFER_COUNT; half++)
+    {
+        descriptor_config.dstAddress = (void *) fifo_dma_buffer[half];
+        descriptor_config.nextDescriptor = &fifo_dma_descriptor[(half + 1) % FIFO_DMA_BUFFER_COUNT];
+
+        if (Cy_DMA_Descriptor_Init(&fifo_dma_descriptor[half], &descriptor_config) != CY_DMA_SUCCESS)
+        {
+            CY_ASSERT(0);
+        }
+    }
+
+    channel_config.descriptor = &fifo_dma_descriptor[0];
+    channel_config.preemptable = false;
+    channel_config.priority = 3;
+    channel_config.enable = false;
+    channel_config.bufferable = false;
+
+    if (Cy_DMA_Channel_Init(FIFO_DMA_HW, FIFO_DMA_CHANNEL, &channel_config) != CY_DMA_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Route the FIFO level trigger of SAR0 to the DataWire channel */
+    if (Cy_TrigMux_Select(FIFO_DMA_TRIGGER_LINE, false, TRIGGER_TYPE_LEVEL) != CY_TRIGMUX_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Interrupt the CPU at the completion of each descriptor */
+    Cy_DMA_Channel_SetInterruptMask(FIFO_DMA_HW, FIFO_DMA_CHANNEL, CY_DMA_INTR_MASK);
+    (void)Cy_SysInt_Init(&fifo_dma_irq_cfg, fifo_dma_interrupt_handler);
+    NVIC_EnableIRQ(APP_NVIC_IRQN(FIFO_DMA_IRQ, FIFO_DMA_IRQ_CM0P_LINE));
+
+    Cy_DMA_Enable(FIFO_DMA_HW);
+    Cy_DMA_Channel_Enable(FIFO_DMA_HW, FIFO_DMA_CHANNEL);
+}
+
+/*******************************************************************************
+* Function Name: fifo_dma_wait_idle
+********************************************************************************
+* Summary:
+* DataWire does not operate in System Deep Sleep mode. This function waits till
+* the channel has moved the pending FIFO entries so that the device can
+* re-enter System Deep Sleep mode.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_dma_wait_idle(void)
+{
+    while(Cy_SAR_FifoGetDataCount(SAR0) >= SAR_FIFO_LEVEL);
+}
+
+/*******************************************************************************
+* Function Name: fifo_dma_is_buffer_ready
+********************************************************************************
+* Summary:
+* This function checks whether a half of the ring is full and waiting to be
+* processed.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if a full buffer is available
+*
+*******************************************************************************/
+bool fifo_dma_is_buffer_ready(void)
+{
+    return((fifo_dma_full_mask & (1U << fifo_dma_read_half)) != 0U);
+}
+
+/*******************************************************************************
+* Function Name: fifo_dma_read
+********************************************************************************
+* Summary:
+* This function returns the next entry of the full buffer in the same format as
+* Cy_SAR_FifoRead.
+*
+* Parameters:
+*  fifo_data: FIFO read structure to be filled
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_dma_read(cy_stc_sar_fifo_read_t * fifo_data)
+{
+    uint32 entry = fifo_dma_buffer[fifo_dma_read_half][fifo_dma_read_index];
+
+    fifo_data->value = (uint16)(entry & FIFO_DMA_RESULT_MASK);
+    fifo_data->channel = (uint16)((entry & FIFO_DMA_CHAN_ID_MASK) >> FIFO_DMA_CHAN_ID_POS);
+
+    if(fifo_dma_read_index < (FIFO_DMA_BUFFER_ENTRIES - 1))
+        fifo_dma_read_index++;
+}
+
+/*******************************************************************************
+* Function Name: fifo_dma_release_buffer
+********************************************************************************
+* Summary:
+* This function hands the buffer back to the DataWire channel once all its
+* entries are read.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_dma_release_buffer(void)
+{
+    uint32 interrupt_state;
+
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    fifo_dma_full_mask &= (uint8)~(1U << fifo_dma_read_half);
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    fifo_dma_read_half = (fifo_dma_read_half + 1) % FIFO_DMA_BUFFER_COUNT;
+    fifo_dma_read_index = 0;
+}
+
+/*******************************************************************************
+* Function Name: fifo_dma_get_overrun_count
+********************************************************************************
+* Summary:
+* This function returns the number of buffers that were refilled by the
+* DataWire channel before the CPU released them.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Overrun count
+*
+*******************************************************************************/
+uint32 fifo_dma_get_overrun_count(void)
+{
+    return(fifo_dma_overrun_count);
+}
+
+/*******************************************************************************
+* Function Name: fifo_dma_interrupt_handler
+********************************************************************************
+* Summary:
+* This function is the handler for the DataWire descriptor completion interrupt.
+* It marks the half that was just filled as full.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void fifo_dma_interrupt_handler(void)
+{
+    Cy_DMA_Channel_ClearInterrupt(FIFO_DMA_HW, FIFO_DMA_CHANNEL);
+
+    if((fifo_dma_full_mask & (1U << fifo_dma_write_half)) != 0U)
+        fifo_dma_overrun_count++;
+
+    fifo_dma_full_mask |= (uint8)(1U << fifo_dma_write_half);
+    fifo_dma_write_half = (fifo_dma_write_half + 1) % FIFO_DMA_BUFFER_COUNT;
+}
+
+#endif /* ENABLE_FIFO_DMA */
+
+/* [] END OF FILE */
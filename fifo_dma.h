@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name: fifo_dma.h
+*
+* Description: This file contains the interface of the DMA based SAR FIFO drain.
+*              A DataWire channel moves the FIFO contents into a double buffered RAM
+*              ring so that the samples are processed only when one half of it is full.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef FIFO_DMA_H_
+#define FIFO_DMA_H_
+
+#include "cy_pdl.h"
+#include "cyhal.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* DataWire block and channel used to read the SAR FIFO */
+#define FIFO_DMA_HW                         (DW0)
+#define FIFO_DMA_CHANNEL                    (0UL)
+#define FIFO_DMA_IRQ                        (cpuss_interrupts_dw0_0_IRQn)
+
+/* NVIC line of the DataWire interrupt when the sensing runs on CM0+ */
+#define FIFO_DMA_IRQ_CM0P_LINE              (4UL)
+
+/* Trigger line that connects the FIFO level trigger output of SAR0 to the
+ * DataWire channel. See the trigger multiplexer table of the device. */
+#define FIFO_DMA_TRIGGER_LINE               (TRIG_OUT_1TO1_1_PASS_FIFO0_TO_PDMA0_TR_IN0)
+
+/* Number of FIFO entries in each half of the double buffer */
+#define FIFO_DMA_BUFFER_ENTRIES             (SAR_FIFO_LEVEL * FIFO_DMA_LEVELS_PER_BUFFER)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to get a copy of the SAR configuration with the FIFO level trigger
+ * output enabled */
+const cy_stc_sar_config_t * fifo_dma_get_sar_config(const cy_stc_sar_config_t * sar_config);
+
+/* Function to initialize and enable the DataWire channel */
+void fifo_dma_init(void);
+
+/* Function to wait till the pending FIFO entries are moved to RAM */
+void fifo_dma_wait_idle(void);
+
+/* Function to check whether a full buffer is waiting to be processed */
+bool fifo_dma_is_buffer_ready(void);
+
+/* Function to get the next entry from the full buffer */
+void fifo_dma_read(cy_stc_sar_fifo_read_t * fifo_data);
+
+/* Function to release the buffer once all its entries are read */
+void fifo_dma_release_buffer(void);
+
+/* Function to get the number of buffers overwritten before being processed */
+uint32 fifo_dma_get_overrun_count(void);
+
+#endif /* FIFO_DMA_H_ */
+
+/* [] END OF FILE */
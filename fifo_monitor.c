@@ -0,0 +1,279 @@
+/******************************************************************************
+* File Name: fifo_monitor.c
+*
+* Description: This file contains the SAR FIFO loss accounting. Overflow and
+*              underflow interrupts are counted, and every FIFO entry read is
+*              checked against the channel order of the scan; the entries
+*              missing before an out-of-sequence entry are counted per channel.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "fifo_monitor.h"
+
+#if ENABLE_FIFO_MONITOR
+
+#if ENABLE_SAMPLE_RING
+#include "sample_ring.h"
+#endif
+
+#if ENABLE_FIFO_DMA
+#include "fifo_dma.h"
+#endif
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Channel expected in the next FIFO entry */
+uint8 fifo_monitor_next_channel = 0;
+
+/* Channel converted after each channel of the scan; set by fifo_monitor_init */
+uint8 fifo_monitor_sequence[FIFO_MONITOR_CHANNELS];
+
+/* Counters; the event counters are updated by the FIFO interrupt */
+static volatile uint32 fifo_monitor_overflow_count = 0;
+static volatile uint32 fifo_monitor_underflow_count = 0;
+static uint32 fifo_monitor_gap_count[FIFO_MONITOR_CHANNELS];
+
+/* Sum of all counters at the last call of fifo_monitor_take_loss */
+static uint32 fifo_monitor_loss_taken = 0;
+
+
+/*******************************************************************************
+* Function Name: fifo_monitor_init
+********************************************************************************
+* Summary:
+* This function builds the channel sequence of the scan and clears the
+* counters. It must be called before the FIFO interrupt is enabled.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_monitor_init(void)
+{
+    uint8 channel;
+    uint8 last = FIFO_MONITOR_CHANNELS;
+
+    fifo_monitor_overflow_count = 0;
+    fifo_monitor_underflow_count = 0;
+    fifo_monitor_loss_taken = 0;
+
+    /* Link every scanned channel to the next one; the last channel is linked
+     * to the first one once it is known */
+    for(channel = 0; channel < FIFO_MONITOR_CHANNELS; channel++)
+    {
+        fifo_monitor_gap_count[channel] = 0;
+        fifo_monitor_sequence[channel] = channel;
+
+        if((SAR_SCAN_CHANNEL_MASK & (1UL << channel)) == 0UL)
+            continue;
+
+        if(last == FIFO_MONITOR_CHANNELS)
+            fifo_monitor_next_channel = channel;
+        else
+            fifo_monitor_sequence[last] = channel;
+
+        last = channel;
+    }
+
+    fifo_monitor_sequence[last & (FIFO_MONITOR_CHANNELS - 1U)] = fifo_monitor_next_channel;
+}
+
+/*******************************************************************************
+* Function Name: fifo_monitor_count_events
+********************************************************************************
+* Summary:
+* This function counts the FIFO overflow and underflow events of the FIFO
+* interrupt status. An overflow means that the SAR results were discarded
+* while the FIFO was full; an underflow, that more entries were read than
+* the FIFO held.
+*
+* Parameters:
+*  status: masked FIFO interrupt status
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_monitor_count_events(uint32 status)
+{
+    if((status & CY_SAR_INTR_FIFO_OVERFLOW) != 0UL)
+        fifo_monitor_overflow_count++;
+
+    if((status & CY_SAR_INTR_FIFO_UNDERFLOW) != 0UL)
+        fifo_monitor_underflow_count++;
+}
+
+/*******************************************************************************
+* Function Name: fifo_monitor_record_gap
+********************************************************************************
+* Summary:
+* This function counts the entries missing between the expected channel and
+* the channel of the entry read. Losses of whole scans keep the channel order
+* and are only seen by the overflow counter.
+*
+* Parameters:
+*  channel: SAR channel of SAR_SCAN_CHANNEL_MASK of the entry read
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_monitor_record_gap(uint8 channel)
+{
+    uint8 missing = fifo_monitor_next_channel;
+
+    while(missing != channel)
+    {
+        fifo_monitor_gap_count[missing]++;
+        missing = fifo_monitor_sequence[missing];
+    }
+}
+
+/*******************************************************************************
+* Function Name: fifo_monitor_take_loss
+********************************************************************************
+* Summary:
+* This function returns whether any counter, including the ring overflow and
+* the DMA overrun counters when enabled, changed since the last call.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if samples were lost
+*
+*******************************************************************************/
+bool fifo_monitor_take_loss(void)
+{
+    uint32 loss = fifo_monitor_overflow_count + fifo_monitor_underflow_count;
+    uint8 channel;
+    bool lost;
+#if ENABLE_SAMPLE_RING
+    sample_ring_stats_t ring_stats;
+
+    sample_ring_get_stats(&ring_stats);
+    loss += ring_stats.overflow_count;
+#endif
+
+#if ENABLE_FIFO_DMA
+    loss += fifo_dma_get_overrun_count();
+#endif
+
+    for(channel = 0; channel < FIFO_MONITOR_CHANNELS; channel++)
+        loss += fifo_monitor_gap_count[channel];
+
+    lost = (loss != fifo_monitor_loss_taken);
+    fifo_monitor_loss_taken = loss;
+
+    return(lost);
+}
+
+/*******************************************************************************
+* Function Name: fifo_monitor_get_stats
+********************************************************************************
+* Summary:
+* This function returns the counters.
+*
+* Parameters:
+*  stats: structure to be filled
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_monitor_get_stats(fifo_monitor_stats_t *stats)
+{
+    uint8 channel;
+
+    stats->overflow_count = fifo_monitor_overflow_count;
+    stats->underflow_count = fifo_monitor_underflow_count;
+
+    for(channel = 0; channel < FIFO_MONITOR_CHANNELS; channel++)
+        stats->gap_count[channel] = fifo_monitor_gap_count[channel];
+}
+
+/*******************************************************************************
+* Function Name: fifo_monitor_report
+********************************************************************************
+* Summary:
+* This function prints the counters over the debug UART.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fifo_monitor_report(void)
+{
+    fifo_monitor_stats_t stats;
+    uint8 channel;
+#if ENABLE_SAMPLE_RING
+    sample_ring_stats_t ring_stats;
+#endif
+
+    fifo_monitor_get_stats(&stats);
+
+    printf("\r\nFIFO overflow: %lu  underflow: %lu\r\n",
+           (unsigned long)stats.overflow_count, (unsigned long)stats.underflow_count);
+
+    for(channel = 0; channel < FIFO_MONITOR_CHANNELS; channel++)
+    {
+        if((SAR_SCAN_CHANNEL_MASK & (1UL << channel)) != 0UL)
+            printf("Channel %u missing entries: %lu\r\n", channel, (unsigned long)stats.gap_count[channel]);
+    }
+
+#if ENABLE_SAMPLE_RING
+    sample_ring_get_stats(&ring_stats);
+    printf("Ring overflow: %lu  high watermark: %lu of %lu\r\n", (unsigned long)ring_stats.overflow_count,
+           (unsigned long)ring_stats.high_watermark, (unsigned long)SAMPLE_RING_SIZE);
+#endif
+
+#if ENABLE_FIFO_DMA
+    printf("DMA buffer overrun: %lu\r\n", (unsigned long)fifo_dma_get_overrun_count());
+#endif
+}
+
+#endif /* ENABLE_FIFO_MONITOR */
+
+/* [] END OF FILE */
@@ -0,0 +1,140 @@
+/******************************************************************************
+* File Name: fifo_monitor.h
+*
+* Description: This file contains the declarations of the SAR FIFO loss
+*              accounting: FIFO overflow and underflow events and gaps in the
+*              channel sequence of the FIFO entries.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef FIFO_MONITOR_H_
+#define FIFO_MONITOR_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Character sent by the host to request the report */
+#define FIFO_MONITOR_REPORT_REQUEST         ('S')
+
+/* Number of channels of the SAR sequencer */
+#define FIFO_MONITOR_CHANNELS               (16U)
+
+/* FIFO interrupts counted by the monitor */
+#define FIFO_MONITOR_INTR_MASK              (CY_SAR_INTR_FIFO_OVERFLOW | CY_SAR_INTR_FIFO_UNDERFLOW)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Loss counters */
+typedef struct
+{
+    /* Number of FIFO overflow and underflow interrupts */
+    uint32 overflow_count;
+    uint32 underflow_count;
+
+    /* Number of entries of each channel missing from the channel sequence */
+    uint32 gap_count[FIFO_MONITOR_CHANNELS];
+} fifo_monitor_stats_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Channel expected in the next FIFO entry */
+extern uint8 fifo_monitor_next_channel;
+
+/* Channel converted after each channel of the scan */
+extern uint8 fifo_monitor_sequence[FIFO_MONITOR_CHANNELS];
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to clear the counters */
+void fifo_monitor_init(void);
+
+/* Function to count the FIFO overflow and underflow events; called from the
+ * FIFO interrupt with the masked interrupt status */
+void fifo_monitor_count_events(uint32 status);
+
+/* Function to count the entries missing before an out-of-sequence entry */
+void fifo_monitor_record_gap(uint8 channel);
+
+/* Function to check whether samples were lost since the last call */
+bool fifo_monitor_take_loss(void);
+
+/* Function to get the counters */
+void fifo_monitor_get_stats(fifo_monitor_stats_t *stats);
+
+/* Function to print the counters */
+void fifo_monitor_report(void);
+
+/*******************************************************************************
+* Function Name: fifo_monitor_check
+********************************************************************************
+* Summary:
+* This function checks the channel of a FIFO entry against the scan order of
+* the sequencer, which converts the channels of SAR_SCAN_CHANNEL_MASK in
+* ascending order. It is called for every entry read, so only the comparison
+* is inlined. An entry of a channel outside SAR_SCAN_CHANNEL_MASK, such as one
+* scanned by design.modus but missing from SENSOR_CONFIG, is skipped; its slot
+* of the scan order links to itself.
+*
+* Parameters:
+*  channel: SAR channel of the entry
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+__STATIC_INLINE void fifo_monitor_check(uint8 channel)
+{
+    channel &= (FIFO_MONITOR_CHANNELS - 1U);
+
+    if((SAR_SCAN_CHANNEL_MASK & (1UL << channel)) == 0UL)
+        return;
+
+    if(channel != fifo_monitor_next_channel)
+        fifo_monitor_record_gap(channel);
+
+    fifo_monitor_next_channel = fifo_monitor_sequence[channel];
+}
+
+#endif /* FIFO_MONITOR_H_ */
+
+/* [] END OF FILE */
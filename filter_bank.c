@@ -0,0 +1,941 @@
+/******************************************************************************
+* File Name: filter_bank.c
+*
+* Description: This file contains the filter bank for the SAR channels. Each
+*              channel runs one of the filter engines - IIR low-pass filter,
+*              moving average, CIC decimator, or median ahead of the IIR - with
+*              the parameters of the descriptor assigned by sensor_table.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "filter_bank.h"
+
+#if ENABLE_CYCLE_PROFILE
+#include <stdio.h>
+#endif
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Run-time state of a channel */
+typedef struct
+{
+    /* Descriptor of the channel */
+    const filter_bank_desc_t *desc;
+
+    /* Filter engine and its window or order */
+    filter_engine_t engine;
+    uint8 length;
+
+    /* Filter variable scaled by 2^shift */
+    int32 state;
+
+    /* Weight of the next sample; initial_coefficient for the first sample and
+     * coefficient afterwards */
+    int32 gain;
+
+    /* Weight of each new sample; the coefficient of the descriptor scaled by
+     * filter_bank_retune */
+    int32 coefficient;
+
+    /* Number of bits the output is reduced by; non-zero when the SAR returns
+     * accumulated rather than averaged results */
+    uint8 output_shift;
+
+    /* State of the moving average, median and CIC engines */
+    union
+    {
+        struct
+        {
+            /* Last samples, oldest first from index, and their number */
+            int16 samples[FILTER_BANK_AVERAGE_MAX_LENGTH];
+            uint8 index;
+            uint8 fill;
+
+            /* Sum of the samples of the window */
+            int32 sum;
+        } window;
+
+        struct
+        {
+            /* Integrator and comb stages; modulo 2^32 arithmetic */
+            uint32 integrator[FILTER_BANK_CIC_MAX_ORDER];
+            uint32 comb[FILTER_BANK_CIC_MAX_ORDER];
+        } cic;
+    } engine_state;
+} filter_bank_channel_t;
+
+/* Filter engine: filters a block of samples and returns the output */
+typedef int32 (*filter_bank_engine_t)(filter_bank_channel_t *state, const int16 *samples, uint32 count);
+
+#if ENABLE_STATIC_PIPELINE
+/* Filter engine of an entry of SENSOR_CONFIG as a direct call. The IIR is
+ * inlined with the coefficient and the shift of the entry as constants; the
+ * output is not shifted, since the filters are not retuned. */
+#define FILTER_BANK_STATIC_RUN_IIR(state, samples, count, length, coefficient, shift) \
+    filter_bank_iir((state), (samples), (count), (shift), (coefficient), (shift))
+#define FILTER_BANK_STATIC_RUN_MOVING_AVERAGE(state, samples, count, ...) \
+    filter_bank_run_moving_average((state), (samples), (count))
+#define FILTER_BANK_STATIC_RUN_CIC(state, samples, count, ...) \
+    filter_bank_run_cic((state), (samples), (count))
+#define FILTER_BANK_STATIC_RUN_MEDIAN_IIR(state, samples, count, ...) \
+    filter_bank_run_median_iir((state), (samples), (count))
+
+/* Case of filter_bank_run_static for an entry of SENSOR_CONFIG */
+#define FILTER_BANK_STATIC_CASE(name, channel_, ref_channel_, type_, engine_, length_, coefficient_, shift_) \
+    case (channel_): \
+        return(FILTER_BANK_STATIC_RUN_##engine_(&filter_bank[channel_], filter_bank_block.samples[channel_], \
+                                                count, (length_), (coefficient_), (shift_)));
+
+/* Filtering of an entry of SENSOR_CONFIG in filter_bank_flush */
+#define FILTER_BANK_STATIC_FLUSH(name, channel_, ...) \
+    filter_bank_process_channel(channel_); \
+    filtered_data[channel_] = filter_bank_output[channel_];
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void filter_bank_load(filter_bank_channel_t *state, const filter_bank_desc_t *desc);
+static bool filter_bank_is_valid(filter_engine_t engine, uint8 length);
+static int32 filter_bank_divide(int32 dividend, uint32 divisor);
+static int32 filter_bank_run_iir(filter_bank_channel_t *state, const int16 *samples, uint32 count);
+__STATIC_FORCEINLINE int32 filter_bank_iir(filter_bank_channel_t *state, const int16 *samples, uint32 count,
+                                           uint32 shift, int32 coefficient, uint32 output_shift);
+static int32 filter_bank_run_moving_average(filter_bank_channel_t *state, const int16 *samples, uint32 count);
+static int32 filter_bank_run_cic(filter_bank_channel_t *state, const int16 *samples, uint32 count);
+static int32 filter_bank_run_median_iir(filter_bank_channel_t *state, const int16 *samples, uint32 count);
+#if ENABLE_STATIC_PIPELINE
+__STATIC_FORCEINLINE int32 filter_bank_run_static(uint8 channel, uint32 count);
+#endif
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Descriptor of the channels not configured with filter_bank_configure: the
+ * first sample is passed through and held */
+static const filter_bank_desc_t filter_bank_default_desc =
+{
+    .coefficient = 0,
+    .shift = 0,
+    .initial_value = 0
+};
+
+/* Filter engines, in the order of filter_engine_t */
+static const filter_bank_engine_t filter_bank_engines[FILTER_ENGINE_COUNT] =
+{
+    filter_bank_run_iir,
+    filter_bank_run_moving_average,
+    filter_bank_run_cic,
+    filter_bank_run_median_iir
+};
+
+/* IIR Filter variables */
+static filter_bank_channel_t filter_bank[FILTER_BANK_CHANNELS];
+
+/* Latest output of each channel */
+static int32 filter_bank_output[FILTER_BANK_CHANNELS];
+
+/* Block being collected from the FIFO */
+filter_bank_block_t filter_bank_block;
+
+
+/*******************************************************************************
+* Function Name: filter_bank_init
+********************************************************************************
+* Summary:
+* This function loads every channel with the pass-through descriptor. The
+* channels in use are then set up with filter_bank_configure.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void filter_bank_init(void)
+{
+    uint8 channel;
+
+    for(channel = 0; channel < FILTER_BANK_CHANNELS; channel++)
+        filter_bank_configure(channel, &filter_bank_default_desc);
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_configure
+********************************************************************************
+* Summary:
+* This function assigns a descriptor to a channel and loads the initial state
+* of the channel from it. Channels with an initial coefficient of 0 are loaded
+* with the first sample they receive. The descriptor is referenced, not
+* copied, so it must stay valid. A descriptor with an invalid engine or
+* length is an error.
+*
+* Parameters:
+*  channel: SAR channel to be configured
+*  desc: filter descriptor of the channel
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void filter_bank_configure(uint8 channel, const filter_bank_desc_t *desc)
+{
+    if(!filter_bank_is_valid(desc->engine, desc->length))
+    {
+        CY_ASSERT(0);
+    }
+
+    filter_bank_load(&filter_bank[channel & FILTER_BANK_CHANNEL_MASK], desc);
+    filter_bank_output[channel & FILTER_BANK_CHANNEL_MASK] = desc->initial_value;
+    filter_bank_block.count[channel & FILTER_BANK_CHANNEL_MASK] = 0;
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_set_engine
+********************************************************************************
+* Summary:
+* This function changes the filter engine of a channel. The window or the
+* integrators of the new engine start empty; the IIR state is kept, so
+* switching between the IIR and the median ahead of the IIR is seamless.
+*
+* Parameters:
+*  channel: SAR channel
+*  engine: new filter engine
+*  length: window of the moving average (a power of 2 up to
+*          FILTER_BANK_AVERAGE_MAX_LENGTH) or of the median (an odd number up
+*          to FILTER_BANK_MEDIAN_MAX_LENGTH), or order of the CIC (1 to
+*          FILTER_BANK_CIC_MAX_ORDER)
+*
+* Return:
+*  true if the engine was changed; false if the length is not valid, or with
+*  ENABLE_STATIC_PIPELINE, where the engine is fixed by SENSOR_CONFIG
+*
+*******************************************************************************/
+bool filter_bank_set_engine(uint8 channel, filter_engine_t engine, uint8 length)
+{
+    filter_bank_channel_t *state = &filter_bank[channel & FILTER_BANK_CHANNEL_MASK];
+
+    if(ENABLE_STATIC_PIPELINE || !filter_bank_is_valid(engine, length))
+        return(false);
+
+    /* Filter the samples collected so far with the current engine */
+    filter_bank_process_channel(channel);
+
+    state->engine = engine;
+    state->length = length;
+    memset(&state->engine_state, 0, sizeof(state->engine_state));
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_load
+********************************************************************************
+* Summary:
+* This function loads the state of a channel from a descriptor.
+*
+* Parameters:
+*  state: state of the channel
+*  desc: filter descriptor of the channel
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void filter_bank_load(filter_bank_channel_t *state, const filter_bank_desc_t *desc)
+{
+    state->desc = desc;
+    state->engine = desc->engine;
+    state->length = desc->length;
+    state->state = desc->initial_value << desc->shift;
+    state->gain = (desc->initial_coefficient != 0) ? desc->initial_coefficient : (1L << desc->shift);
+    state->coefficient = desc->coefficient;
+    state->output_shift = 0;
+    memset(&state->engine_state, 0, sizeof(state->engine_state));
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_is_valid
+********************************************************************************
+* Summary:
+* This function checks the length of a filter engine.
+*
+* Parameters:
+*  engine: filter engine
+*  length: window or order of the engine
+*
+* Return:
+*  true if the engine and the length are valid
+*
+*******************************************************************************/
+static bool filter_bank_is_valid(filter_engine_t engine, uint8 length)
+{
+    switch(engine)
+    {
+        case FILTER_ENGINE_IIR:
+            return(true);
+
+        case FILTER_ENGINE_MOVING_AVERAGE:
+            return((length != 0U) && (length <= FILTER_BANK_AVERAGE_MAX_LENGTH) && ((length & (length - 1U)) == 0U));
+
+        case FILTER_ENGINE_CIC:
+            return((length != 0U) && (length <= FILTER_BANK_CIC_MAX_ORDER));
+
+        case FILTER_ENGINE_MEDIAN_IIR:
+            return(((length & 1U) != 0U) && (length <= FILTER_BANK_MEDIAN_MAX_LENGTH));
+
+        default:
+            return(false);
+    }
+}
+
+/*******************************************************************************
+* Function Name: low_pass_filter
+********************************************************************************
+* Summary:
+* This function implements IIR filter for each SAR channel data. The parameters
+* are taken from the descriptor of the channel, so the same code runs for every
+* channel without a branch per sample. The first sample is weighted with the
+* initial coefficient, which replaces the separate first-run handling. The IIR
+* is applied whatever the filter engine of the channel.
+*
+* Parameters:
+*  Data to be filtered and the data source.
+*
+* Return:
+*  Filtered data
+*
+*******************************************************************************/
+int32 low_pass_filter(int32 input, uint8 data_source)
+{
+    filter_bank_channel_t *channel = &filter_bank[data_source & FILTER_BANK_CHANNEL_MASK];
+    const filter_bank_desc_t *desc = channel->desc;
+
+    input <<= desc->shift;
+
+    channel->state = channel->state + (((input - channel->state) >> desc->shift) * channel->gain);
+    channel->gain = channel->coefficient;
+
+    /* Round to the nearest integer */
+    filter_bank_output[data_source & FILTER_BANK_CHANNEL_MASK] =
+        (channel->state + ((1L << (desc->shift + channel->output_shift)) >> 1)) >> (desc->shift + channel->output_shift);
+
+    return(filter_bank_output[data_source & FILTER_BANK_CHANNEL_MASK]);
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_process_channel
+********************************************************************************
+* Summary:
+* This function runs the filter engine of a channel over the collected samples
+* of the channel. With ENABLE_STATIC_PIPELINE, the engine of the channel is
+* selected at compile time from SENSOR_CONFIG.
+*
+* Parameters:
+*  channel: SAR channel to be filtered
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void filter_bank_process_channel(uint8 channel)
+{
+    uint32 count = filter_bank_block.count[channel & FILTER_BANK_CHANNEL_MASK];
+#if !ENABLE_STATIC_PIPELINE
+    filter_bank_channel_t *state = &filter_bank[channel & FILTER_BANK_CHANNEL_MASK];
+#endif
+
+    if(count == 0)
+        return;
+
+#if ENABLE_STATIC_PIPELINE
+    filter_bank_output[channel & FILTER_BANK_CHANNEL_MASK] =
+        filter_bank_run_static(channel & FILTER_BANK_CHANNEL_MASK, count);
+#else
+    filter_bank_output[channel & FILTER_BANK_CHANNEL_MASK] =
+        filter_bank_engines[state->engine](state, filter_bank_block.samples[channel & FILTER_BANK_CHANNEL_MASK], count);
+#endif
+
+    filter_bank_block.count[channel & FILTER_BANK_CHANNEL_MASK] = 0;
+}
+
+#if ENABLE_STATIC_PIPELINE
+/*******************************************************************************
+* Function Name: filter_bank_process_block
+********************************************************************************
+* Summary:
+* This function filters the full block of a channel. The number of samples is
+* the constant FILTER_BANK_BLOCK_SIZE, so the compiler can unroll the sample
+* loop of the IIR completely.
+*
+* Parameters:
+*  channel: SAR channel to be filtered
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void filter_bank_process_block(uint8 channel)
+{
+    filter_bank_output[channel & FILTER_BANK_CHANNEL_MASK] =
+        filter_bank_run_static(channel & FILTER_BANK_CHANNEL_MASK, FILTER_BANK_BLOCK_SIZE);
+
+    filter_bank_block.count[channel & FILTER_BANK_CHANNEL_MASK] = 0;
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_run_static
+********************************************************************************
+* Summary:
+* This function runs the engine of a channel given by SENSOR_CONFIG, with one
+* case per entry. Channels without an entry run their engine through the
+* engine table.
+*
+* Parameters:
+*  channel: SAR channel to be filtered
+*  count: number of samples, at least 1
+*
+* Return:
+*  Filter output
+*
+*******************************************************************************/
+__STATIC_FORCEINLINE int32 filter_bank_run_static(uint8 channel, uint32 count)
+{
+    switch(channel)
+    {
+        SENSOR_CONFIG(FILTER_BANK_STATIC_CASE)
+
+        default:
+            return(filter_bank_engines[filter_bank[channel].engine](&filter_bank[channel],
+                                                                    filter_bank_block.samples[channel], count));
+    }
+}
+#endif
+
+/*******************************************************************************
+* Function Name: filter_bank_divide
+********************************************************************************
+* Summary:
+* This function divides with rounding to the nearest integer.
+*
+* Parameters:
+*  dividend: signed dividend
+*  divisor: divisor, not 0
+*
+* Return:
+*  Rounded quotient
+*
+*******************************************************************************/
+static int32 filter_bank_divide(int32 dividend, uint32 divisor)
+{
+    int32 half = (int32)(divisor >> 1);
+
+    return((dividend + ((dividend >= 0) ? half : -half)) / (int32)divisor);
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_run_iir
+********************************************************************************
+* Summary:
+* This function runs the IIR filter over a block of samples. The descriptor is
+* read and the state is loaded once per block, so the loop works on registers
+* only. Results are bit-exact with low_pass_filter.
+*
+* The first-order IIR is a recursion on the previous output, so successive
+* samples cannot be computed in parallel with the dual 16-bit SIMD
+* instructions without changing the rounding; the loop is unrolled instead.
+*
+* Parameters:
+*  state: state of the channel
+*  samples: block of samples
+*  count: number of samples, at least 1
+*
+* Return:
+*  Filter output
+*
+*******************************************************************************/
+static int32 filter_bank_run_iir(filter_bank_channel_t *state, const int16 *samples, uint32 count)
+{
+    return(filter_bank_iir(state, samples, count, state->desc->shift, state->coefficient,
+                           state->desc->shift + state->output_shift));
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_iir
+********************************************************************************
+* Summary:
+* This function is the loop of the IIR filter. It is inlined, so that the
+* parameters are constants in code generated from SENSOR_CONFIG.
+*
+* Parameters:
+*  state: state of the channel
+*  samples: block of samples
+*  count: number of samples, at least 1
+*  shift: number of fractional bits of the filter state
+*  coefficient: weight of each new sample, out of 2^shift
+*  output_shift: number of bits the state is reduced by for the output
+*
+* Return:
+*  Filter output
+*
+*******************************************************************************/
+__STATIC_FORCEINLINE int32 filter_bank_iir(filter_bank_channel_t *state, const int16 *samples, uint32 count,
+                                           uint32 shift, int32 coefficient, uint32 output_shift)
+{
+    int32 filt;
+    uint32 i;
+
+    /* First sample is weighted with the current gain; it is the initial
+     * coefficient if the channel has not received any sample yet */
+    filt = state->state + (((((int32)samples[0]) << shift) - state->state) >> shift) * state->gain;
+
+    for(i = 1; (i + 4) <= count; i += 4)
+    {
+        filt += (((((int32)samples[i])     << shift) - filt) >> shift) * coefficient;
+        filt += (((((int32)samples[i + 1]) << shift) - filt) >> shift) * coefficient;
+        filt += (((((int32)samples[i + 2]) << shift) - filt) >> shift) * coefficient;
+        filt += (((((int32)samples[i + 3]) << shift) - filt) >> shift) * coefficient;
+    }
+
+    for(; i < count; i++)
+        filt += (((((int32)samples[i]) << shift) - filt) >> shift) * coefficient;
+
+    state->state = filt;
+    state->gain = coefficient;
+
+    /* Round to the nearest integer */
+    return((filt + ((1L << output_shift) >> 1)) >> output_shift);
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_run_moving_average
+********************************************************************************
+* Summary:
+* This function keeps the running sum of the last length samples and returns
+* its mean at the end of the block. Till the window is full, the mean is
+* taken over the samples received.
+*
+* Parameters:
+*  state: state of the channel
+*  samples: block of samples
+*  count: number of samples, at least 1
+*
+* Return:
+*  Filter output
+*
+*******************************************************************************/
+static int32 filter_bank_run_moving_average(filter_bank_channel_t *state, const int16 *samples, uint32 count)
+{
+    int16 *window = state->engine_state.window.samples;
+    const uint32 mask = (uint32)state->length - 1U;
+    uint32 index = state->engine_state.window.index;
+    int32 sum = state->engine_state.window.sum;
+    uint32 fill;
+    uint32 i;
+
+    for(i = 0; i < count; i++)
+    {
+        sum += (int32)samples[i] - (int32)window[index];
+        window[index] = samples[i];
+        index = (index + 1U) & mask;
+    }
+
+    fill = state->engine_state.window.fill + count;
+
+    if(fill > state->length)
+        fill = state->length;
+
+    state->engine_state.window.index = (uint8)index;
+    state->engine_state.window.fill = (uint8)fill;
+    state->engine_state.window.sum = sum;
+
+    return(filter_bank_divide(sum, fill << state->output_shift));
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_run_cic
+********************************************************************************
+* Summary:
+* This function runs a CIC decimator of order length with a differential delay
+* of one block: every sample goes through the integrators, and the combs run
+* once per block. The output is normalized by the gain count^length, so the
+* number of samples per block must stay the same from block to block; the
+* first length blocks are a transient.
+*
+* Parameters:
+*  state: state of the channel
+*  samples: block of samples
+*  count: number of samples, at least 1
+*
+* Return:
+*  Filter output
+*
+*******************************************************************************/
+static int32 filter_bank_run_cic(filter_bank_channel_t *state, const int16 *samples, uint32 count)
+{
+    uint32 *integrator = state->engine_state.cic.integrator;
+    uint32 *comb = state->engine_state.cic.comb;
+    const uint32 order = state->length;
+    uint32 i0 = integrator[0];
+    uint32 i1 = integrator[1];
+    uint32 i2 = integrator[2];
+    uint32 value;
+    uint32 previous;
+    uint32 gain = 1U;
+    uint32 stage;
+    uint32 i;
+
+    /* Unused integrators stay at 0 */
+    switch(order)
+    {
+        case 1U:
+            for(i = 0; i < count; i++)
+                i0 += (uint32)(int32)samples[i];
+            value = i0;
+            break;
+
+        case 2U:
+            for(i = 0; i < count; i++)
+            {
+                i0 += (uint32)(int32)samples[i];
+                i1 += i0;
+            }
+            value = i1;
+            break;
+
+        default:
+            for(i = 0; i < count; i++)
+            {
+                i0 += (uint32)(int32)samples[i];
+                i1 += i0;
+                i2 += i1;
+            }
+            value = i2;
+            break;
+    }
+
+    integrator[0] = i0;
+    integrator[1] = i1;
+    integrator[2] = i2;
+
+    for(stage = 0; stage < order; stage++)
+    {
+        previous = comb[stage];
+        comb[stage] = value;
+        value -= previous;
+        gain *= count;
+    }
+
+    return(filter_bank_divide((int32)value, gain << state->output_shift));
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_run_median_iir
+********************************************************************************
+* Summary:
+* This function replaces every sample by the median of the last length
+* samples, which rejects spikes shorter than length / 2 samples, and feeds the
+* medians through the IIR filter. Till the window is full, the median is
+* taken over the samples received.
+*
+* Parameters:
+*  state: state of the channel
+*  samples: block of samples
+*  count: number of samples, at least 1
+*
+* Return:
+*  Filter output
+*
+*******************************************************************************/
+static int32 filter_bank_run_median_iir(filter_bank_channel_t *state, const int16 *samples, uint32 count)
+{
+    int16 *window = state->engine_state.window.samples;
+    const uint32 shift = state->desc->shift;
+    const uint32 output_shift = shift + state->output_shift;
+    const uint32 length = state->length;
+    uint32 index = state->engine_state.window.index;
+    uint32 fill = state->engine_state.window.fill;
+    int16 sorted[FILTER_BANK_MEDIAN_MAX_LENGTH];
+    int16 value;
+    int32 filt = state->state;
+    uint32 i;
+    uint32 j;
+    uint32 k;
+
+    for(i = 0; i < count; i++)
+    {
+        window[index] = samples[i];
+        index = (index + 1U < length) ? (index + 1U) : 0U;
+
+        if(fill < length)
+            fill++;
+
+        /* Insertion sort of the window */
+        for(j = 0; j < fill; j++)
+        {
+            value = window[j];
+
+            for(k = j; (k > 0U) && (sorted[k - 1U] > value); k--)
+                sorted[k] = sorted[k - 1U];
+
+            sorted[k] = value;
+        }
+
+        filt += (((((int32)sorted[fill >> 1]) << shift) - filt) >> shift) * state->gain;
+        state->gain = state->coefficient;
+    }
+
+    state->engine_state.window.index = (uint8)index;
+    state->engine_state.window.fill = (uint8)fill;
+    state->state = filt;
+
+    /* Round to the nearest integer */
+    return((filt + ((1L << output_shift) >> 1)) >> output_shift);
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_flush
+********************************************************************************
+* Summary:
+* This function filters the samples collected for every channel and copies the
+* latest output of each channel. With ENABLE_STATIC_PIPELINE, only the
+* channels of SENSOR_CONFIG are processed and copied; the other entries of
+* filtered_data are left unchanged.
+*
+* Parameters:
+*  filtered_data: array of FILTER_BANK_CHANNELS entries to receive the outputs
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void filter_bank_flush(int32 *filtered_data)
+{
+#if ENABLE_STATIC_PIPELINE
+    SENSOR_CONFIG(FILTER_BANK_STATIC_FLUSH)
+#else
+    uint8 channel;
+
+    for(channel = 0; channel < FILTER_BANK_CHANNELS; channel++)
+    {
+        filter_bank_process_channel(channel);
+        filtered_data[channel] = filter_bank_output[channel];
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_average
+********************************************************************************
+* Summary:
+* This function replaces the IIR filter of every channel by the rounded mean
+* of the samples collected since the last call, and copies the latest output
+* of each channel. Channels without samples keep their previous output. The
+* block of a channel must not fill up between two calls, or its samples are
+* filtered by filter_bank_push instead.
+*
+* Parameters:
+*  filtered_data: array of FILTER_BANK_CHANNELS entries to receive the outputs
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void filter_bank_average(int32 *filtered_data)
+{
+    uint8 channel;
+    uint32 count;
+    uint32 i;
+    int32 sum;
+
+    for(channel = 0; channel < FILTER_BANK_CHANNELS; channel++)
+    {
+        count = filter_bank_block.count[channel];
+
+        if(count != 0U)
+        {
+            sum = 0;
+
+            for(i = 0; i < count; i++)
+                sum += filter_bank_block.samples[channel][i];
+
+            /* Round to the nearest integer */
+            filter_bank_output[channel] = (sum + (sum >= 0 ? (int32)(count / 2U) : -(int32)(count / 2U))) / (int32)count;
+            filter_bank_block.count[channel] = 0;
+        }
+
+        filtered_data[channel] = filter_bank_output[channel];
+    }
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_retune
+********************************************************************************
+* Summary:
+* This function adapts the filter of a channel to a lower sample rate. The
+* coefficient of the descriptor is multiplied by rate_divider, which keeps the
+* cut-off frequency for attenuation constants well above 1; it is limited to
+* 2^shift, where the filter passes the samples through. The output is reduced
+* by output_shift bits, so accumulated SAR results are reported in the same
+* ADC counts as single conversions.
+*
+* Parameters:
+*  channel: SAR channel to be retuned
+*  rate_divider: sample rate of the descriptor divided by the new sample rate
+*  output_shift: log2 of the number of conversions accumulated per sample
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void filter_bank_retune(uint8 channel, uint32 rate_divider, uint8 output_shift)
+{
+    filter_bank_channel_t *state = &filter_bank[channel & FILTER_BANK_CHANNEL_MASK];
+    const filter_bank_desc_t *desc = state->desc;
+    int32 coefficient;
+
+    coefficient = (int32)desc->coefficient * (int32)rate_divider;
+
+    if(coefficient > (1L << desc->shift))
+        coefficient = (1L << desc->shift);
+
+    /* Keep the initial coefficient of a channel without any sample yet */
+    if(state->gain == state->coefficient)
+        state->gain = coefficient;
+
+    /* The filter state keeps the scale of the samples */
+    state->state = (state->state >> state->output_shift) << output_shift;
+
+    state->coefficient = coefficient;
+    state->output_shift = output_shift;
+}
+
+/*******************************************************************************
+* Function Name: filter_bank_preload
+********************************************************************************
+* Summary:
+* This function loads the IIR state of a channel with a settled output, such
+* as the output retained across a reset, instead of the initial value of its
+* descriptor. The first sample is then weighted with the coefficient rather
+* than the initial coefficient. The window and the integrators of the other
+* engines start empty, and the samples collected so far are dropped.
+*
+* Parameters:
+*  channel: SAR channel
+*  value: filter output in ADC counts
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void filter_bank_preload(uint8 channel, int32 value)
+{
+    filter_bank_channel_t *state = &filter_bank[channel & FILTER_BANK_CHANNEL_MASK];
+
+    state->state = value << (state->desc->shift + state->output_shift);
+    state->gain = state->coefficient;
+    memset(&state->engine_state, 0, sizeof(state->engine_state));
+
+    filter_bank_output[channel & FILTER_BANK_CHANNEL_MASK] = value;
+    filter_bank_block.count[channel & FILTER_BANK_CHANNEL_MASK] = 0;
+}
+
+#if ENABLE_CYCLE_PROFILE
+/*******************************************************************************
+* Function Name: filter_bank_benchmark
+********************************************************************************
+* Summary:
+* This function runs every filter engine over one block of test samples and
+* prints the cycles per sample measured with the DWT cycle counter, which
+* must be enabled by cycle_profile_init. The channels are not affected.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void filter_bank_benchmark(void)
+{
+    static const filter_bank_desc_t benchmark_desc[] =
+    {
+        { .engine = FILTER_ENGINE_IIR, .length = 0, .coefficient = 4, .shift = 8 },
+        { .engine = FILTER_ENGINE_MOVING_AVERAGE, .length = 8, .coefficient = 4, .shift = 8 },
+        { .engine = FILTER_ENGINE_CIC, .length = 1, .coefficient = 4, .shift = 8 },
+        { .engine = FILTER_ENGINE_CIC, .length = 3, .coefficient = 4, .shift = 8 },
+        { .engine = FILTER_ENGINE_MEDIAN_IIR, .length = 3, .coefficient = 4, .shift = 8 },
+        { .engine = FILTER_ENGINE_MEDIAN_IIR, .length = 5, .coefficient = 4, .shift = 8 }
+    };
+    static const char * const benchmark_name[] =
+    {
+        "IIR", "Moving average 8", "CIC order 1", "CIC order 3", "Median 3 + IIR", "Median 5 + IIR"
+    };
+    int16 samples[FILTER_BANK_BLOCK_SIZE];
+    filter_bank_channel_t state;
+    uint32 cycles;
+    uint32 start;
+    uint8 test;
+    uint32 i;
+
+    /* Noisy ramp around mid scale */
+    for(i = 0; i < FILTER_BANK_BLOCK_SIZE; i++)
+        samples[i] = (int16)(1024 + (int32)i + (int32)((i * 37U) & 0x1FU));
+
+    printf("\r\nFilter engine     Cycles/sample  (%u samples)\r\n", (unsigned int)FILTER_BANK_BLOCK_SIZE);
+
+    for(test = 0; test < (sizeof(benchmark_desc) / sizeof(benchmark_desc[0])); test++)
+    {
+        filter_bank_load(&state, &benchmark_desc[test]);
+
+        /* The first block fills the window; the second one is measured */
+        (void)filter_bank_engines[state.engine](&state, samples, FILTER_BANK_BLOCK_SIZE);
+
+        start = DWT->CYCCNT;
+        (void)filter_bank_engines[state.engine](&state, samples, FILTER_BANK_BLOCK_SIZE);
+        cycles = DWT->CYCCNT - start;
+
+        printf("%-16s  %6lu.%02lu\r\n", benchmark_name[test], (unsigned long)(cycles / FILTER_BANK_BLOCK_SIZE),
+               (unsigned long)(((cycles % FILTER_BANK_BLOCK_SIZE) * 100UL) / FILTER_BANK_BLOCK_SIZE));
+    }
+}
+#endif /* ENABLE_CYCLE_PROFILE */
+
+/* [] END OF FILE */
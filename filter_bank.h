@@ -0,0 +1,204 @@
+/******************************************************************************
+* File Name: filter_bank.h
+*
+* Description: This file contains the interface of the IIR low-pass filter bank.
+*              Each SAR channel is filtered with the parameters of the descriptor
+*              assigned to it by sensor_table.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef FILTER_BANK_H_
+#define FILTER_BANK_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of channels supported by the SAR sequencer */
+#define FILTER_BANK_CHANNELS                (16)
+
+/* Mask applied to the channel number; keeps the table access in range */
+#define FILTER_BANK_CHANNEL_MASK            (FILTER_BANK_CHANNELS - 1)
+
+/* Number of samples of a channel collected before the block is filtered. One
+ * FIFO level holds 40 samples of each of the 3 channels. */
+#define FILTER_BANK_BLOCK_SIZE              (SAR_FIFO_LEVEL / CHANNEL_COUNT)
+
+/* Longest window of the moving average engine; a power of 2 */
+#define FILTER_BANK_AVERAGE_MAX_LENGTH      (16U)
+
+/* Longest window of the median engine; an odd number */
+#define FILTER_BANK_MEDIAN_MAX_LENGTH       (7U)
+
+/* Highest order of the CIC engine. The gain of the CIC is the number of
+ * samples per block to the power of the order, which must fit in 31 bits
+ * with the 12-bit samples. */
+#define FILTER_BANK_CIC_MAX_ORDER           (3U)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Filter engine of a channel. Each engine takes the block of samples of the
+ * channel collected in one wake-up and gives one output. */
+typedef enum
+{
+    FILTER_ENGINE_IIR,              /* First-order IIR low-pass filter */
+    FILTER_ENGINE_MOVING_AVERAGE,   /* Mean of the last length samples */
+    FILTER_ENGINE_CIC,              /* CIC decimator of order length, decimating the block */
+    FILTER_ENGINE_MEDIAN_IIR,       /* Median of the last length samples, then the IIR */
+    FILTER_ENGINE_COUNT
+} filter_engine_t;
+
+/* Filter descriptor of a SAR channel. The IIR filter is
+ *     state = state + ((input - state) / 2^shift) * coefficient
+ * with input and state scaled by 2^shift, which gives an attenuation constant
+ * a = 2^shift / coefficient. */
+typedef struct
+{
+    /* Filter engine; the IIR unless set */
+    filter_engine_t engine;
+
+    /* Window of the moving average (a power of 2) or of the median (an odd
+     * number), or order of the CIC; not used by the IIR */
+    uint8 length;
+
+    /* Weight of each new sample, out of 2^shift */
+    uint16 coefficient;
+
+    /* Number of fractional bits of the filter state */
+    uint8 shift;
+
+    /* Weight of the first sample, out of 2^shift. 0 loads the filter with the
+     * first sample. */
+    uint16 initial_coefficient;
+
+    /* Filter output before the first sample, in ADC counts */
+    int32 initial_value;
+} filter_bank_desc_t;
+
+/* Samples of each channel de-interleaved from the FIFO */
+typedef struct
+{
+    /* Number of samples collected for each channel */
+    uint16 count[FILTER_BANK_CHANNELS];
+
+    /* Samples of each channel in FIFO order */
+    int16 samples[FILTER_BANK_CHANNELS][FILTER_BANK_BLOCK_SIZE];
+} filter_bank_block_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Block being collected from the FIFO */
+extern filter_bank_block_t filter_bank_block;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to load the initial state of all the channels */
+void filter_bank_init(void);
+
+/* Function to assign a descriptor to a channel and load its initial state */
+void filter_bank_configure(uint8 channel, const filter_bank_desc_t *desc);
+
+/* Function to change the filter engine of a channel at run time */
+bool filter_bank_set_engine(uint8 channel, filter_engine_t engine, uint8 length);
+
+/* Function to measure the cycles per sample of each filter engine */
+void filter_bank_benchmark(void);
+
+/* IIR Filter implementation */
+int32 low_pass_filter(int32 input, uint8 data_source);
+
+/* Function to filter the collected samples of one channel */
+void filter_bank_process_channel(uint8 channel);
+
+#if ENABLE_STATIC_PIPELINE
+/* Function to filter the full block of one channel */
+void filter_bank_process_block(uint8 channel);
+#endif
+
+/* Function to filter the collected samples of all channels and get the latest
+ * output of each channel */
+void filter_bank_flush(int32 *filtered_data);
+
+/* Function to average the collected samples of all channels instead of
+ * filtering them and get the latest output of each channel */
+void filter_bank_average(int32 *filtered_data);
+
+/* Function to adapt the filter of a channel to a lower sample rate and to
+ * accumulated samples */
+void filter_bank_retune(uint8 channel, uint32 rate_divider, uint8 output_shift);
+
+/* Function to load the filter of a channel with a settled output */
+void filter_bank_preload(uint8 channel, int32 value);
+
+/*******************************************************************************
+* Function Name: filter_bank_push
+********************************************************************************
+* Summary:
+* This function adds a FIFO entry to the sample array of its channel. The
+* array is filtered when it is full; the remaining samples are filtered by
+* filter_bank_flush.
+*
+* Parameters:
+*  channel: SAR channel of the sample
+*  value: ADC result
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+__STATIC_INLINE void filter_bank_push(uint8 channel, int16 value)
+{
+    channel &= FILTER_BANK_CHANNEL_MASK;
+
+    filter_bank_block.samples[channel][filter_bank_block.count[channel]] = value;
+
+    if(++filter_bank_block.count[channel] == FILTER_BANK_BLOCK_SIZE)
+#if ENABLE_STATIC_PIPELINE
+        filter_bank_process_block(channel);
+#else
+        filter_bank_process_channel(channel);
+#endif
+}
+
+#endif /* FILTER_BANK_H_ */
+
+/* [] END OF FILE */
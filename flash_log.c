@@ -0,0 +1,471 @@
+/******************************************************************************
+* File Name: flash_log.c
+*
+* Description: This file contains the flash data logger. Readings are delta
+*              encoded into a RAM row, which is programmed into the next row of a
+*              ring in the work flash when it is full. Rows are only appended, so
+*              every row is erased once per turn of the ring.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "cyhal.h"
+#include "flash_log.h"
+#include "sample_log.h"
+#include "timebase.h"
+
+#if ENABLE_FLASH_LOG
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void flash_log_put_header(uint8 *row, uint32 row_sequence, uint32 first_sequence, uint32 wall_time_s,
+                                 uint16 count, uint16 length);
+static uint32 flash_log_get_le(const uint8 *data, uint8 size);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Ring of rows in the work flash; see APP_WORK_FLASH_SECTION */
+APP_WORK_FLASH_SECTION CY_ALIGN(FLASH_LOG_ROW_SIZE)
+static uint8 flash_log_storage[FLASH_LOG_ROWS][FLASH_LOG_ROW_SIZE] = {{0}};
+
+static cyhal_flash_t flash_log_flash;
+
+/* Row being filled, its length including the header, and its records */
+CY_ALIGN(4) static uint8 flash_log_row[FLASH_LOG_ROW_SIZE];
+static uint16 flash_log_length;
+static uint16 flash_log_count;
+
+/* Sequence number and wall-clock time of the first reading of the row being
+ * filled, and the previous reading of the row */
+static uint32 flash_log_first_sequence;
+static uint32 flash_log_first_wall_s;
+static telemetry_reading_t flash_log_last;
+
+/* Next flash row to be programmed, that is, the oldest row, and its sequence
+ * number */
+static uint8 flash_log_write_row;
+static uint32 flash_log_row_sequence;
+
+/* Index of the rows: sequence number of the first reading and number of
+ * readings; FLASH_LOG_INVALID for rows without valid data */
+static uint32 flash_log_index_first[FLASH_LOG_ROWS];
+static uint16 flash_log_index_count[FLASH_LOG_ROWS];
+
+/* Upload in progress: first reading wanted and rows of the ring left, from
+ * the oldest one */
+static bool flash_log_uploading = false;
+static uint32 flash_log_upload_sequence;
+static uint8 flash_log_upload_offset;
+
+/* Header sent at the end of an upload; its first reading is the sequence
+ * number to resume from, and its record count the number of readings dropped
+ * since the startup */
+static uint8 flash_log_end[FLASH_LOG_HEADER_SIZE];
+
+/* Number of readings dropped while an upload kept the row from being
+ * programmed */
+static uint32 flash_log_drop_count = 0;
+
+
+/*******************************************************************************
+* Function Name: flash_log_init
+********************************************************************************
+* Summary:
+* This function checks the header and the CRC of every row of the ring and
+* builds the index in RAM. The log continues after the row with the highest
+* row sequence number, so no erase or copy is needed at startup. Rows left
+* incomplete by a reset during programming fail the CRC check and are reused
+* first.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void flash_log_init(void)
+{
+    const uint8 *row;
+    uint32 newest = FLASH_LOG_INVALID;
+    uint16 length;
+    uint8 index;
+
+    if(cyhal_flash_init(&flash_log_flash) != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    flash_log_write_row = 0;
+    flash_log_row_sequence = 0;
+    flash_log_first_sequence = 0;
+
+    for(index = 0; index < FLASH_LOG_ROWS; index++)
+    {
+        row = flash_log_storage[index];
+        length = (uint16)flash_log_get_le(&row[18], 2);
+        flash_log_index_first[index] = FLASH_LOG_INVALID;
+        flash_log_index_count[index] = 0;
+
+        if((flash_log_get_le(&row[0], 4) != FLASH_LOG_MAGIC) || (length > (FLASH_LOG_ROW_SIZE - FLASH_LOG_HEADER_SIZE)))
+            continue;
+
+        /* The CRC covers the header up to the CRC field and the records */
+        if(telemetry_crc16_update(telemetry_crc16(row, FLASH_LOG_CRC_OFFSET), &row[FLASH_LOG_HEADER_SIZE], length) !=
+           (uint16)flash_log_get_le(&row[FLASH_LOG_CRC_OFFSET], 2))
+            continue;
+
+        flash_log_index_first[index] = flash_log_get_le(&row[8], 4);
+        flash_log_index_count[index] = (uint16)flash_log_get_le(&row[16], 2);
+
+        if((newest == FLASH_LOG_INVALID) || (flash_log_get_le(&row[4], 4) > newest))
+        {
+            newest = flash_log_get_le(&row[4], 4);
+            flash_log_write_row = (uint8)((index + 1U) % FLASH_LOG_ROWS);
+            flash_log_row_sequence = newest + 1U;
+            flash_log_first_sequence = flash_log_index_first[index] + flash_log_index_count[index];
+        }
+    }
+
+    flash_log_length = FLASH_LOG_HEADER_SIZE;
+    flash_log_count = 0;
+    flash_log_uploading = false;
+}
+
+/*******************************************************************************
+* Function Name: flash_log_add
+********************************************************************************
+* Summary:
+* This function encodes a reading into the row being filled, in the record
+* format of the sample log. When the record does not fit, the row is
+* programmed first and the reading starts the next row. No flash operation
+* takes place till then, so the readings are written once per row; the row
+* is not programmed during an upload, and the reading is then dropped.
+*
+* Parameters:
+*  reading: reading to be logged
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void flash_log_add(const telemetry_reading_t *reading)
+{
+    uint8 record[FLASH_LOG_MAX_RECORD_SIZE];
+    uint16 size;
+
+    if(flash_log_count == 0U)
+        memset(&flash_log_last, 0, sizeof(flash_log_last));
+
+    size = (uint16)(sample_log_encode(record, reading, &flash_log_last) - record);
+
+    if((flash_log_length + size) > FLASH_LOG_ROW_SIZE)
+    {
+        if(flash_log_uploading || !flash_log_commit())
+        {
+            flash_log_drop_count++;
+            return;
+        }
+
+        /* The first record of a row is taken against zero */
+        memset(&flash_log_last, 0, sizeof(flash_log_last));
+        size = (uint16)(sample_log_encode(record, reading, &flash_log_last) - record);
+    }
+
+    if(flash_log_count == 0U)
+        flash_log_first_wall_s = (uint32)(timebase_get_wall_ms() / 1000U);
+
+    memcpy(&flash_log_row[flash_log_length], record, size);
+    flash_log_length += size;
+    flash_log_count++;
+    flash_log_last = *reading;
+}
+
+/*******************************************************************************
+* Function Name: flash_log_commit
+********************************************************************************
+* Summary:
+* This function completes the header of the row being filled and programs it
+* into the oldest row of the ring. Programming a row takes a few milliseconds,
+* during which the SAR keeps filling the FIFO.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the row was programmed; false if it is empty or programming failed
+*
+*******************************************************************************/
+bool flash_log_commit(void)
+{
+    uint8 row = flash_log_write_row;
+
+    if(flash_log_count == 0U)
+        return(false);
+
+    flash_log_put_header(flash_log_row, flash_log_row_sequence, flash_log_first_sequence, flash_log_first_wall_s,
+                         flash_log_count, (uint16)(flash_log_length - FLASH_LOG_HEADER_SIZE));
+    memset(&flash_log_row[flash_log_length], 0, FLASH_LOG_ROW_SIZE - flash_log_length);
+
+    /* The row being programmed no longer holds valid data */
+    flash_log_index_first[row] = FLASH_LOG_INVALID;
+    flash_log_index_count[row] = 0;
+
+    if(cyhal_flash_write(&flash_log_flash, (uint32)&flash_log_storage[row][0], (const uint32 *)flash_log_row) != CY_RSLT_SUCCESS)
+        return(false);
+
+    flash_log_index_first[row] = flash_log_first_sequence;
+    flash_log_index_count[row] = flash_log_count;
+    flash_log_write_row = (uint8)((row + 1U) % FLASH_LOG_ROWS);
+    flash_log_row_sequence++;
+
+    flash_log_first_sequence += flash_log_count;
+    flash_log_length = FLASH_LOG_HEADER_SIZE;
+    flash_log_count = 0;
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: flash_log_get_next_sequence
+********************************************************************************
+* Summary:
+* This function returns the sequence number the next reading gets. Sequence
+* numbers continue over a reset from the last row programmed.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Sequence number of the next reading
+*
+*******************************************************************************/
+uint32 flash_log_get_next_sequence(void)
+{
+    return(flash_log_first_sequence + flash_log_count);
+}
+
+/*******************************************************************************
+* Function Name: flash_log_start_upload
+********************************************************************************
+* Summary:
+* This function programs the row being filled, so that all the readings are
+* in the flash, and starts the upload of the rows holding readings from the
+* given sequence number on. The rows are found with the index, without reading
+* the flash.
+*
+* Parameters:
+*  sequence: sequence number of the first reading wanted; the upload starts
+*            with the oldest row if it is no longer in the log
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void flash_log_start_upload(uint32 sequence)
+{
+    (void)flash_log_commit();
+
+    flash_log_upload_sequence = sequence;
+    flash_log_upload_offset = 0;
+    flash_log_uploading = true;
+}
+
+#if SENSING_CORE_TELEMETRY
+/*******************************************************************************
+* Function Name: flash_log_receive_upload
+********************************************************************************
+* Summary:
+* This function reads the sequence number following FLASH_LOG_UPLOAD_REQUEST
+* from the host and starts the upload.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the upload was started
+*
+*******************************************************************************/
+bool flash_log_receive_upload(void)
+{
+    uint32 sequence;
+
+    if(!telemetry_read_decimal(&sequence, FLASH_LOG_REQUEST_CHAR_TIMEOUT_MS))
+        return(false);
+
+    flash_log_start_upload(sequence);
+
+    return(true);
+}
+#endif
+
+/*******************************************************************************
+* Function Name: flash_log_upload
+********************************************************************************
+* Summary:
+* This function sends the next row of the upload directly from the flash, as
+* stored: header and records. The upload ends with a header without records,
+* whose first reading is the sequence number to resume from and whose record
+* count is the number of readings dropped since the startup. It is to be
+* called at every wake-up; a row is sent only when the UART is free.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true while the upload is in progress
+*
+*******************************************************************************/
+bool flash_log_upload(void)
+{
+    uint8 row;
+
+    if(!flash_log_uploading)
+        return(false);
+
+    if(telemetry_is_busy())
+        return(true);
+
+    while(flash_log_upload_offset < FLASH_LOG_ROWS)
+    {
+        row = (uint8)((flash_log_write_row + flash_log_upload_offset) % FLASH_LOG_ROWS);
+        flash_log_upload_offset++;
+
+        if((flash_log_index_first[row] != FLASH_LOG_INVALID) &&
+           ((flash_log_index_first[row] + flash_log_index_count[row]) > flash_log_upload_sequence))
+        {
+            (void)telemetry_write_buffer(flash_log_storage[row],
+                                         FLASH_LOG_HEADER_SIZE + (uint16)flash_log_get_le(&flash_log_storage[row][18], 2));
+            return(true);
+        }
+    }
+
+    /* No row is programmed during the upload, so the row being filled still
+     * starts at the sequence number to resume from */
+    flash_log_put_header(flash_log_end, FLASH_LOG_INVALID, flash_log_first_sequence, 0,
+                         (flash_log_drop_count > 0xFFFFUL) ? 0xFFFFU : (uint16)flash_log_drop_count, 0);
+
+    (void)telemetry_write_buffer(flash_log_end, FLASH_LOG_HEADER_SIZE);
+    flash_log_uploading = false;
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: flash_log_is_uploading
+********************************************************************************
+* Summary:
+* This function checks whether an upload is in progress.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true till the end of the upload is sent
+*
+*******************************************************************************/
+bool flash_log_is_uploading(void)
+{
+    return(flash_log_uploading);
+}
+
+/*******************************************************************************
+* Function Name: flash_log_put_header
+********************************************************************************
+* Summary:
+* This function writes a row header and its CRC, which covers the header up
+* to the CRC field and the records following the header.
+*
+* Parameters:
+*  row: row; the records follow the header
+*  row_sequence: sequence number of the row
+*  first_sequence: sequence number of the first reading
+*  wall_time_s: wall-clock time of the first reading in seconds since 1970
+*  count: number of records
+*  length: number of bytes of the records
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void flash_log_put_header(uint8 *row, uint32 row_sequence, uint32 first_sequence, uint32 wall_time_s,
+                                 uint16 count, uint16 length)
+{
+    const uint32 fields[4] = { FLASH_LOG_MAGIC, row_sequence, first_sequence, wall_time_s };
+    uint16 crc;
+    uint8 i;
+
+    for(i = 0; i < 16U; i++)
+        row[i] = (uint8)(fields[i / 4U] >> (8U * (i % 4U)));
+
+    row[16] = (uint8)count;
+    row[17] = (uint8)(count >> 8);
+    row[18] = (uint8)length;
+    row[19] = (uint8)(length >> 8);
+
+    crc = telemetry_crc16_update(telemetry_crc16(row, FLASH_LOG_CRC_OFFSET), &row[FLASH_LOG_HEADER_SIZE], length);
+    row[FLASH_LOG_CRC_OFFSET] = (uint8)crc;
+    row[FLASH_LOG_CRC_OFFSET + 1U] = (uint8)(crc >> 8);
+}
+
+/*******************************************************************************
+* Function Name: flash_log_get_le
+********************************************************************************
+* Summary:
+* This function reads a little-endian field.
+*
+* Parameters:
+*  data: first byte of the field
+*  size: number of bytes, up to 4
+*
+* Return:
+*  Value of the field
+*
+*******************************************************************************/
+static uint32 flash_log_get_le(const uint8 *data, uint8 size)
+{
+    uint32 value = 0;
+
+    while(size-- > 0U)
+        value = (value << 8) | data[size];
+
+    return(value);
+}
+#endif /* ENABLE_FLASH_LOG */
+
+/* [] END OF FILE */
@@ -0,0 +1,116 @@
+/******************************************************************************
+* File Name: flash_log.h
+*
+* Description: This file contains the declarations of the flash data logger: the
+*              readings are delta encoded into rows of the work flash, written as
+*              an append-only ring for wear levelling, and uploaded on request.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef FLASH_LOG_H_
+#define FLASH_LOG_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Character sent by the host to request an upload; it is followed by the
+ * sequence number of the first reading wanted and a carriage return, for
+ * example "U0\r" for the whole log */
+#define FLASH_LOG_UPLOAD_REQUEST            ('U')
+
+/* Time allowed for each character of the upload request */
+#define FLASH_LOG_REQUEST_CHAR_TIMEOUT_MS   (20U)
+
+/* Number of flash rows of the ring; each row is programmed as a whole. The
+ * default leaves 4 KB of the work flash for the calibration row. */
+#ifndef FLASH_LOG_ROWS
+#define FLASH_LOG_ROWS                      (56U)
+#endif
+
+#define FLASH_LOG_ROW_SIZE                  (CY_FLASH_SIZEOF_ROW)
+
+#if ENABLE_FLASH_LOG && (((FLASH_LOG_ROWS + ENABLE_CALIBRATION) * FLASH_LOG_ROW_SIZE) > APP_WORK_FLASH_SIZE)
+#error "FLASH_LOG_ROWS and the calibration row do not fit in the work flash"
+#endif
+
+/* Row header: magic (4), row sequence (4), sequence of the first reading (4),
+ * wall-clock seconds of the first reading (4), record count (2), payload
+ * length (2), CRC (2). Multi-byte fields are little-endian. */
+#define FLASH_LOG_MAGIC                     (0x31474C46UL)
+#define FLASH_LOG_HEADER_SIZE               (22U)
+#define FLASH_LOG_CRC_OFFSET                (20U)
+
+/* Longest record of sample_log_encode */
+#define FLASH_LOG_MAX_RECORD_SIZE           (14U)
+
+/* Sequence number of a row that holds no valid data */
+#define FLASH_LOG_INVALID                   (0xFFFFFFFFUL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to scan the rows and build the index */
+void flash_log_init(void);
+
+/* Function to add a reading to the log */
+void flash_log_add(const telemetry_reading_t *reading);
+
+/* Function to program the row being filled */
+bool flash_log_commit(void);
+
+/* Function to get the sequence number of the next reading */
+uint32 flash_log_get_next_sequence(void);
+
+/* Function to start the upload of the readings from a sequence number */
+void flash_log_start_upload(uint32 sequence);
+
+/* Function to read the upload request from the host and start the upload */
+bool flash_log_receive_upload(void);
+
+/* Function to send the next row of the upload */
+bool flash_log_upload(void);
+
+/* Function to check whether an upload is in progress */
+bool flash_log_is_uploading(void);
+
+#endif /* FLASH_LOG_H_ */
+
+/* [] END OF FILE */
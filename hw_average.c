@@ -0,0 +1,211 @@
+/******************************************************************************
+* File Name: hw_average.c
+*
+* Description: This file contains the run-time SAR hardware averaging
+*              configuration. The SAR sequencer averages several conversions
+*              per sample, so the software filters are retuned to the lower
+*              sample rate.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "hw_average.h"
+#include "filter_bank.h"
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+const hw_average_config_t hw_average_default_config =
+{
+    .count = 16,
+    .shift = true,
+    .channel_mask = (1U << ALS_SENSOR_CHANNEL),
+    .timer_period = SAR_TIMER_PERIOD
+};
+
+const hw_average_config_t hw_average_oversample_config =
+{
+    .count = 16,
+    .shift = true,
+    .channel_mask = (1U << REF_RESISTOR_CHANNEL) | (1U << THERMISTOR_SENSOR_CHANNEL) |
+                    (1U << ALS_SENSOR_CHANNEL),
+    .timer_period = SAR_TIMER_PERIOD * 16UL
+};
+
+/* Configuration in use */
+static hw_average_config_t hw_average_config =
+{
+    .count = 16,
+    .shift = true,
+    .channel_mask = (1U << ALS_SENSOR_CHANNEL),
+    .timer_period = SAR_TIMER_PERIOD
+};
+
+
+/*******************************************************************************
+* Function Name: hw_average_set
+********************************************************************************
+* Summary:
+* This function programs the averaging count, the shift, and the averaged
+* channels of the SAR sequencer, and the PASS timer period. The timer is
+* stopped while the SAR is reconfigured and started afterwards; call it right
+* after the FIFO is drained, since the entries in the FIFO were converted with
+* the previous configuration.
+*
+* The filters of the channels in use are retuned for the new sample rate, and
+* the outputs of accumulating channels are shifted back to 12-bit counts.
+*
+* Parameters:
+*  config: averaging configuration
+*
+* Return:
+*  true if the configuration was applied; false if it is not valid or the scan
+*  does not fit in the timer period
+*
+*******************************************************************************/
+bool hw_average_set(const hw_average_config_t *config)
+{
+    uint32 conversions = 0;
+    uint32 avg_cnt;
+    uint32 rate_divider;
+    uint8 output_shift;
+    uint8 channel;
+
+    if((config->count == 0U) || (config->count > HW_AVERAGE_MAX_COUNT) ||
+       ((config->count & (config->count - 1U)) != 0U) || (config->timer_period == 0UL))
+        return(false);
+
+    if(!config->shift && (config->count > HW_AVERAGE_MAX_ACCUMULATE_COUNT))
+        return(false);
+
+    /* Check that the scan completes within the timer period; 1000000 / 32768
+     * = 15625 / 512 us per timer clock cycle */
+    for(channel = 0; channel < FILTER_BANK_CHANNELS; channel++)
+    {
+        if((SAR_SCAN_CHANNEL_MASK & (1UL << channel)) != 0UL)
+            conversions += ((config->channel_mask & (1U << channel)) != 0U) ? config->count : 1U;
+    }
+
+    if((conversions * HW_AVERAGE_CONVERSION_US) >=
+       ((config->timer_period * 15625UL) / 512UL))
+        return(false);
+
+    /* AVG_CNT selects 2^(AVG_CNT + 1) conversions */
+    avg_cnt = (config->count > 1U) ? (31UL - __CLZ((uint32)config->count) - 1UL) : 0UL;
+
+    Cy_SysAnalog_TimerDisable(PASS);
+
+    /* Let the scan in progress complete */
+    while((SAR_STATUS(SAR0) & SAR_STATUS_BUSY_Msk) != 0UL);
+
+    CY_REG32_CLR_SET(SAR_SAMPLE_CTRL(SAR0), SAR_SAMPLE_CTRL_AVG_CNT, avg_cnt);
+    CY_REG32_CLR_SET(SAR_SAMPLE_CTRL(SAR0), SAR_SAMPLE_CTRL_AVG_SHIFT, config->shift ? 1UL : 0UL);
+
+    rate_divider = (config->timer_period + (SAR_TIMER_PERIOD / 2UL)) / SAR_TIMER_PERIOD;
+
+    if(rate_divider == 0UL)
+        rate_divider = 1UL;
+
+    for(channel = 0; channel < FILTER_BANK_CHANNELS; channel++)
+    {
+        bool averaged;
+
+        if((SAR_SCAN_CHANNEL_MASK & (1UL << channel)) == 0UL)
+            continue;
+
+        averaged = (config->count > 1U) && ((config->channel_mask & (1U << channel)) != 0U);
+
+        CY_REG32_CLR_SET(SAR_CHAN_CONFIG(SAR0, channel), SAR_CHAN_CONFIG_AVG_EN, averaged ? 1UL : 0UL);
+
+        output_shift = (averaged && !config->shift) ? (uint8)(avg_cnt + 1UL) : 0U;
+        filter_bank_retune(channel, rate_divider, output_shift);
+    }
+
+    Cy_SysAnalog_TimerSetPeriod(PASS, config->timer_period);
+    Cy_SysAnalog_TimerEnable(PASS);
+
+    hw_average_config = *config;
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: hw_average_get
+********************************************************************************
+* Summary:
+* This function returns the averaging configuration in use.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Configuration in use
+*
+*******************************************************************************/
+const hw_average_config_t * hw_average_get(void)
+{
+    return(&hw_average_config);
+}
+
+/*******************************************************************************
+* Function Name: hw_average_get_wake_period_ms
+********************************************************************************
+* Summary:
+* This function returns the wake-up period for the timer period in use.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Wake-up period in milliseconds
+*
+*******************************************************************************/
+uint32 hw_average_get_wake_period_ms(void)
+{
+    uint32 period_ms;
+
+    /* SAR_FIFO_LEVEL entries are collected in SAR_FIFO_LEVEL / CHANNEL_COUNT scans */
+    period_ms = (SAR_FIFO_LEVEL * hw_average_config.timer_period * 1000UL) /
+                (SAR_TIMER_CLOCK_HZ * CHANNEL_COUNT);
+
+#if ENABLE_FIFO_DMA
+    period_ms *= FIFO_DMA_LEVELS_PER_BUFFER;
+#endif
+
+    return(period_ms);
+}
+
+/* [] END OF FILE */
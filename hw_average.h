@@ -0,0 +1,105 @@
+/******************************************************************************
+* File Name: hw_average.h
+*
+* Description: This file contains the declarations of the run-time SAR hardware
+*              averaging configuration.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef HW_AVERAGE_H_
+#define HW_AVERAGE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Conversion time of one sample set in design.modus (10 ksps) */
+#define HW_AVERAGE_CONVERSION_US            (100UL)
+
+/* Range of the number of conversions averaged per sample */
+#define HW_AVERAGE_MAX_COUNT                (256U)
+#define HW_AVERAGE_MAX_ACCUMULATE_COUNT     (16U)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Hardware averaging configuration */
+typedef struct
+{
+    /* Number of conversions averaged per sample of the enabled channels: 1
+     * disables averaging, otherwise a power of 2 from 2 to 256 */
+    uint16 count;
+
+    /* true to shift the accumulated result back to 12 bits; false to return
+     * the sum, for up to HW_AVERAGE_MAX_ACCUMULATE_COUNT conversions */
+    bool shift;
+
+    /* Channels averaged, bit n for channel n */
+    uint16 channel_mask;
+
+    /* PASS timer period in timer clock cycles. Raise it by count to get
+     * the same number of conversions with count times fewer FIFO entries. */
+    uint32 timer_period;
+} hw_average_config_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Configuration of design.modus: 16 conversions averaged on the ALS channel,
+ * 400 sps */
+extern const hw_average_config_t hw_average_default_config;
+
+/* 16 conversions averaged on every channel at 25 sps */
+extern const hw_average_config_t hw_average_oversample_config;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to reconfigure the SAR averaging and to retune the filter bank */
+bool hw_average_set(const hw_average_config_t *config);
+
+/* Function to get the configuration in use */
+const hw_average_config_t * hw_average_get(void);
+
+/* Function to get the wake-up period for the configuration in use */
+uint32 hw_average_get_wake_period_ms(void);
+
+#endif /* HW_AVERAGE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,214 @@
+/******************************************************************************
+* File Name: led_dimmer.c
+*
+* Description: This file contains the LED dimmer. The duty cycle of the PWM is
+*              reloaded only when the light intensity leaves a deadband, and
+*              System Deep Sleep is held off only while the LED is dimmed.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cyhal.h"
+#include "cybsp.h"
+#include "led_dimmer.h"
+#include "power_manager.h"
+
+#if ENABLE_LED_DIMMING
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static bool led_dimmer_is_static(void);
+
+static uint8 led_dimmer_get_target(uint8 light_intensity);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static cyhal_pwm_t led_dimmer_pwm;
+
+/* Brightness in percentage and the light intensity it was set for */
+static uint8 led_dimmer_brightness = 0;
+static uint8 led_dimmer_light = 100;
+
+/* Deep sleep client. The TCPWM is clocked from CLK_PERI, which stops in
+ * System Deep Sleep, and the output then holds its level; deep sleep is only
+ * entered while the output is constant, that is, with the LED fully OFF or
+ * fully ON. */
+static const power_manager_client_t led_dimmer_power_client =
+{
+    .is_ready = led_dimmer_is_static,
+    .before_sleep = NULL,
+    .after_wake = NULL
+};
+
+
+/*******************************************************************************
+* Function Name: led_dimmer_init
+********************************************************************************
+* Summary:
+* This function starts the PWM on the user LED pin with the LED OFF and
+* registers the deep sleep client.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void led_dimmer_init(void)
+{
+    if(cyhal_pwm_init(&led_dimmer_pwm, CYBSP_USER_LED2, NULL) != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Force the first reload, to OFF */
+    led_dimmer_brightness = 100;
+    (void)led_dimmer_update(100);
+
+    if(cyhal_pwm_start(&led_dimmer_pwm) != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    power_manager_register(&led_dimmer_power_client);
+}
+
+/*******************************************************************************
+* Function Name: led_dimmer_update
+********************************************************************************
+* Summary:
+* This function sets the brightness for the light intensity. The PWM is only
+* reloaded when the light intensity has changed by more than
+* LED_DIMMER_DEADBAND since the last reload, or when the brightness reaches
+* 0 or 100%, so that the ends are always reached and deep sleep is allowed
+* again. Between two reloads, the TCPWM generates the output without the CPU.
+*
+* Parameters:
+*  light_intensity: filtered light intensity in percentage
+*
+* Return:
+*  true if the LED is ON, dimmed or not
+*
+*******************************************************************************/
+bool led_dimmer_update(uint8 light_intensity)
+{
+    uint8 target = led_dimmer_get_target(light_intensity);
+    int32 change = (int32)light_intensity - (int32)led_dimmer_light;
+    float duty;
+
+    if((target != led_dimmer_brightness) &&
+       ((target == 0U) || (target == 100U) || (change > LED_DIMMER_DEADBAND) || (change < -LED_DIMMER_DEADBAND)))
+    {
+        /* The duty cycle is the share of the period with the output high */
+        duty = (CYBSP_LED_STATE_ON == 0) ? (100.0f - (float)target) : (float)target;
+
+        if(cyhal_pwm_set_duty_cycle(&led_dimmer_pwm, duty, LED_DIMMER_FREQUENCY_HZ) == CY_RSLT_SUCCESS)
+        {
+            led_dimmer_brightness = target;
+            led_dimmer_light = light_intensity;
+        }
+    }
+
+    return(led_dimmer_brightness > 0U);
+}
+
+/*******************************************************************************
+* Function Name: led_dimmer_get_brightness
+********************************************************************************
+* Summary:
+* This function returns the brightness set last.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  LED brightness in percentage (0 - 100)
+*
+*******************************************************************************/
+uint8 led_dimmer_get_brightness(void)
+{
+    return(led_dimmer_brightness);
+}
+
+/*******************************************************************************
+* Function Name: led_dimmer_is_static
+********************************************************************************
+* Summary:
+* This function is the deep sleep check of the LED dimmer. It only changes in
+* the main loop, so no interrupt is needed to retry deep sleep.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the LED is fully OFF or fully ON
+*
+*******************************************************************************/
+static bool led_dimmer_is_static(void)
+{
+    return((led_dimmer_brightness == 0U) || (led_dimmer_brightness == 100U));
+}
+
+/*******************************************************************************
+* Function Name: led_dimmer_get_target
+********************************************************************************
+* Summary:
+* This function maps the light intensity linearly to the brightness, from
+* full brightness at LED_DIMMER_LIGHT_FULL to OFF at LED_DIMMER_LIGHT_OFF.
+*
+* Parameters:
+*  light_intensity: light intensity in percentage
+*
+* Return:
+*  Brightness in percentage (0 - 100)
+*
+*******************************************************************************/
+static uint8 led_dimmer_get_target(uint8 light_intensity)
+{
+    if(light_intensity >= LED_DIMMER_LIGHT_OFF)
+        return(0);
+
+    if(light_intensity <= LED_DIMMER_LIGHT_FULL)
+        return(100);
+
+    return((uint8)(((LED_DIMMER_LIGHT_OFF - (int32)light_intensity) * 100) /
+                   (LED_DIMMER_LIGHT_OFF - LED_DIMMER_LIGHT_FULL)));
+}
+#endif /* ENABLE_LED_DIMMING */
+
+/* [] END OF FILE */
@@ -0,0 +1,79 @@
+/******************************************************************************
+* File Name: led_dimmer.h
+*
+* Description: This file contains the declarations of the LED dimmer: the user
+*              LED is driven by a TCPWM PWM whose duty cycle follows the ambient
+*              light.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LED_DIMMER_H_
+#define LED_DIMMER_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* PWM frequency in Hz, well above the flicker fusion frequency */
+#define LED_DIMMER_FREQUENCY_HZ             (1000U)
+
+/* Light intensity in percentage from which the LED is OFF, and up to which it
+ * is at full brightness; the brightness is linear in between */
+#define LED_DIMMER_LIGHT_OFF                (ALS_HIGH_THRESHOLD)
+#define LED_DIMMER_LIGHT_FULL               (0)
+
+/* Change of the light intensity in percentage below which the duty cycle is
+ * kept, so that the filter noise does not reload the PWM at every wake-up */
+#define LED_DIMMER_DEADBAND                 (2)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to start the PWM with the LED OFF */
+void led_dimmer_init(void);
+
+/* Function to follow the light intensity */
+bool led_dimmer_update(uint8 light_intensity);
+
+/* Function to get the LED brightness in percentage */
+uint8 led_dimmer_get_brightness(void);
+
+#endif /* LED_DIMMER_H_ */
+
+/* [] END OF FILE */
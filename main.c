@@ -44,60 +44,92 @@
 #include "cyhal.h"
 #include "cybsp.h"
 #include "cy_retarget_io.h"
-#include "math.h"
+#include "app_config.h"
+#include "filter_bank.h"
+#include "pipeline.h"
+#include "sensor_table.h"
+#include "telemetry.h"
+#include "timebase.h"
+#include "cycle_profile.h"
+#include "power_manager.h"
+
+#if ENABLE_SAMPLE_LOG
+#include "sample_log.h"
+#endif
+
+#if ENABLE_ADAPTIVE_RATE
+#include "adaptive_rate.h"
+#endif
+
+#if ENABLE_FIFO_DMA
+#include "fifo_dma.h"
+#endif
+
+#if ENABLE_ALS_RANGE_WAKE
+#include "als_range.h"
+#endif
+
+#if ENABLE_HW_AVERAGE
+#include "hw_average.h"
+#endif
+
+#if ENABLE_SAMPLE_RING
+#include "sample_ring.h"
+#endif
+
+#if ENABLE_FIFO_MONITOR
+#include "fifo_monitor.h"
+#endif
+
+#if ENABLE_SCAN_WINDOWS
+#include "excitation.h"
+#endif
+
+#if ENABLE_FIFO_CAPTURE
+#include "fifo_capture.h"
+#endif
+
+#if ENABLE_FLASH_LOG
+#include "flash_log.h"
+#endif
+
+#if ENABLE_CALIBRATION
+#include "calibration.h"
+#endif
+
+#if ENABLE_LED_DIMMING
+#include "led_dimmer.h"
+#endif
+
+#if ENABLE_TREND_ALARMS
+#include "trend.h"
+#endif
+
+#if ENABLE_REGISTER_MAP
+#include "register_map.h"
+#endif
+
+#if ENABLE_WARM_RESTART
+#include "warm_restart.h"
+#endif
+
+#if !SENSING_CORE_TELEMETRY
+#include "sensor_ipc.h"
+#endif
+
+/* This file holds the sensing application; when the sensing runs on CM0+, the
+ * CM4 image is built from main_cm4.c instead */
+#if !ENABLE_CM0P_SENSING || (CY_CPU_CORTEX_M0P)
 
 /*******************************************************************************
 * Macros
 ********************************************************************************/
-/* Defines for the ADC channels */
-#define THERMISTOR_SENSOR_CHANNEL           (1)
-#define REF_RESISTOR_CHANNEL                (0)
-#define ALS_SENSOR_CHANNEL                  (2)
-
-/* Number of channels used */
-#define CHANNEL_COUNT                       (3)
-
-/* Reference resistor in series with the thermistor is of 10kohm */
-#define R_REFERENCE                         (float)(10000)
-
-/* Beta constant of NCP18XH103F03RB thermistor is 3380 Kelvin. See the thermistor
-   data sheet for more details. */
-#define B_CONSTANT                          (float)(3380)
-
-/* Resistance of the thermistor is 10K at 25 degrees C (from the data sheet)
-   Therefore R0 = 10000 Ohm, and T0 = 298.15 Kelvin, which gives
-   R_INFINITY = R0 e^(-B_CONSTANT / T0) = 0.1192855 */
-#define R_INFINITY                          (float)(0.1192855)
-
-/* Zero Kelvin in degree C */
-#define ABSOLUTE_ZERO                       (float)(-273.15)
-
-/* ALS offset in Percent */
-/* To configure this value, begin with offset of 0 and note down the lowest ALS
-percent value. Configure the ALS_OFFSET with the lowest observed ALS percent. */
-#define ALS_OFFSET                          (20)
-
-/* ALS low threshold value - if ALS percentage is lower than this value, user
- * LED is turned ON */
-#define ALS_LOW_THRESHOLD                   (45)
-
-/* ALS high threshold value - if ALS percentage is higher than this value, user
- * LED is turned OFF */
-#define ALS_HIGH_THRESHOLD                  (55)
+/* NVIC line of the FIFO interrupt when the sensing runs on CM0+ */
+#define FIFO_IRQ_CM0P_LINE                  (2UL)
 
 /*******************************************************************************
 * Function Prototypes
 ********************************************************************************/
-/* Function to convert the measured voltage in the thermistor circuit into
- * temperature */
-float get_temperature(int32 therm_count, int32 ref_count);
-
-/* Function to convert the measured voltage in the ALS circuit into percentage */
-uint8 get_light_intensity(int32 adc_count);
-
-/* IIR Filter implementation */
-int32 low_pass_filter(int32 input, uint8 data_source);
-
 /* FIFO Interrupt Handler */
 void sar_fifo_interrupt_handler(void);
 
@@ -109,13 +141,10 @@ void init_analog_resources(void);
 /*******************************************************************************
 * Global Variables
 ********************************************************************************/
-/* IIR Filter variables */
-int32 filt_var[CHANNEL_COUNT];
-
 /* FIFO interrupt configuration structure */
 /* Source is set to FIFO 0 and Priority as 7 */
 const cy_stc_sysint_t fifo_irq_cfg = {
-    .intrSrc = (IRQn_Type) pass_interrupt_fifo_0_IRQn,
+    .intrSrc = APP_INTR_SRC(pass_interrupt_fifo_0_IRQn, FIFO_IRQ_CM0P_LINE),
     .intrPriority = 7
 };
 
@@ -147,25 +176,77 @@ int main(void)
     /* Variable to capture return value of functions */
     cy_rslt_t result;
 
+    /* Set when the filter state was retained across the last reset */
+    bool warm_start = false;
+
     /* FIFO read structure */
     cy_stc_sar_fifo_read_t fifo_data = {0};
 
     /* Variable for filtered reference voltage (thermistor circuit) and als data */
-    int32 filtered_data[CHANNEL_COUNT];
-
-    /* Temperature value in deg C */
-    float temperature;
+    int32 filtered_data[FILTER_BANK_CHANNELS] = {0};
 
-    /* Light intensity in percentage */
-    uint8 light_intensity;
+    /* Output of each entry of the sensor table */
+    int32 sensor_values[SENSOR_COUNT];
 
-    /* Variable to initialize IIR filter for the first iteration */
-    uint8 first_run[CHANNEL_COUNT]= {true, true, true};
+    /* Light intensity in percentage compared with the LED thresholds */
+    uint8 led_light_intensity;
 
     /* Variable for number of samples accumulated in FIFO */
-    uint8 data_count;
-
-    uint16 display_delay = 0;
+    uint16 data_count;
+
+    /* Set when the SAR range detection of the ALS channel woke up the device */
+    bool range_event = false;
+
+#if ENABLE_ALS_RANGE_WAKE
+    /* Set when the FIFO level was reached, and the FIFO entries read in this
+     * wake-up */
+    bool level_event;
+    uint16 fifo_count;
+
+    /* Latest unfiltered ALS result and the LED state before this wake-up */
+    int32 als_latest = 0;
+    bool led_was_on;
+#endif
+
+#if SENSING_CORE_TELEMETRY && !ENABLE_SAMPLE_LOG
+    /* Wall-clock time of the next UART update in milliseconds */
+    uint64_t display_due_ms = 0;
+#endif
+
+#if ENABLE_FLASH_LOG
+    /* Wall-clock time of the next reading logged into the flash */
+    uint64_t flash_log_due_ms = 0;
+#endif
+
+#if ENABLE_TREND_ALARMS
+    /* Wall-clock time of the next sample of the statistics */
+    uint64_t trend_due_ms = 0;
+#endif
+
+    /* Period of the last wake-up in milliseconds */
+    uint32 wake_period_ms;
+
+    /* Wall-clock time of the reading in milliseconds */
+    uint64_t wall_ms;
+
+    /* Reading sent over UART */
+    telemetry_reading_t reading = {0};
+
+#if SENSING_CORE_TELEMETRY
+#if ENABLE_HOST_COMMANDS
+    /* Command character received from the host; 0 if none */
+    uint8 host_command;
+#endif
+
+#if ENABLE_SAMPLE_LOG
+    /* Set when the sample log is to be sent */
+    bool log_flush;
+#else
+    /* Line sent over UART and its length */
+    char display_line[TELEMETRY_BUFFER_SIZE];
+    uint16 display_length;
+#endif
+#endif
 
     /* Initialize the device and board peripherals */
     result = cybsp_init() ;
@@ -175,6 +256,13 @@ int main(void)
         CY_ASSERT(0);
     }
 
+#if ENABLE_WARM_RESTART
+    /* Check whether the watchdog or a software reset left a valid retained
+     * state */
+    warm_start = warm_restart_init();
+#endif
+
+#if SENSING_CORE_TELEMETRY
     /* Initialize the debug uart */
     result = cy_retarget_io_init(CYBSP_DEBUG_UART_TX, CYBSP_DEBUG_UART_RX,
                                      CY_RETARGET_IO_BAUDRATE);
@@ -183,20 +271,114 @@ int main(void)
         CY_ASSERT(0);
     }
 
-    /* Print message */
+#if ENABLE_WARM_RESTART
+    /* Keep the readings printed before the reset on the screen */
+    if(warm_start)
+        printf("Warm restart %lu\r\n", (unsigned long)warm_restart_get_count());
+    else
+#endif
+    {
+        /* Print message */
+
+        /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
+        printf("\x1b[2J\x1b[;H");
+
+        printf("---------------------------------------------------------------------------\r\n");
+        printf("PSoC 6 MCU: SAR ADC Low-Power Sensing - Thermistor and Ambient Light Sensor\r\n");
+        printf("---------------------------------------------------------------------------\r\n\n");
+        printf("Touch the thermistor and block/increase the light over the ambient light \r\n");
+        printf("sensor to observe change in the readings. \r\n\n");
+    }
+#endif
 
-    /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
-    printf("\x1b[2J\x1b[;H");
+#if ENABLE_CYCLE_PROFILE
+    /* Start the cycle counter */
+    cycle_profile_init();
+#endif
 
-    printf("---------------------------------------------------------------------------\r\n");
-    printf("PSoC 6 MCU: SAR ADC Low-Power Sensing - Thermistor and Ambient Light Sensor\r\n");
-    printf("---------------------------------------------------------------------------\r\n\n");
-    printf("Touch the thermistor and block/increase the light over the ambient light \r\n");
-    printf("sensor to observe change in the readings. \r\n\n");
+    /* Load the initial state of the IIR filter of each sensor */
+    sensor_table_init();
+
+#if ENABLE_CALIBRATION
+    /* Load the coefficients of the device before the first conversion */
+    calibration_init();
+#endif
+
+#if ENABLE_PIPELINE_CHECK
+    /* Check the filter bank and the conversions against the reference outputs;
+     * the check already passed before a warm restart */
+    if(!warm_start && !pipeline_check())
+    {
+        CY_ASSERT(0);
+    }
+#endif
+
+#if SENSING_CORE_TELEMETRY && ENABLE_SAMPLE_LOG
+    /* Clear the sample log */
+    sample_log_init();
+#endif
+
+#if ENABLE_ADAPTIVE_RATE
+    /* Select the sample rate policy; adaptive_rate_set_policy(NULL) keeps the
+     * fixed 400 sps rate */
+    adaptive_rate_set_policy(&adaptive_rate_default_policy);
+#endif
+
+#if ENABLE_SAMPLE_RING
+    /* Empty the ring filled by the FIFO interrupt */
+    sample_ring_init();
+#endif
+
+#if ENABLE_FIFO_MONITOR
+    /* Clear the loss counters */
+    fifo_monitor_init();
+#endif
+
+#if ENABLE_FIFO_CAPTURE
+    /* The capture is started by the host */
+    fifo_capture_init();
+#endif
+
+#if ENABLE_FLASH_LOG
+    /* Find the newest row of the log; the sequence numbers continue from it */
+    flash_log_init();
+#endif
+
+#if ENABLE_TREND_ALARMS
+    /* Clear the statistics and load the default alarm rules */
+    trend_init();
+#endif
+
+    /* Start the time base of the readings; this also selects the LFCLK source
+     * of the PASS timer. After a warm restart, the first readings are sent
+     * without waiting for the second tick of the RTC. */
+    timebase_init(!warm_start);
 
     /* Initialize and enable analog resources */
     init_analog_resources();
 
+#if SENSING_CORE_TELEMETRY && ENABLE_ASYNC_TELEMETRY
+    /* Wait till the banner is sent; further output is sent asynchronously */
+    while(cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj) == true);
+
+    telemetry_init();
+#endif
+
+#if ENABLE_REGISTER_MAP
+    /* Answer the host on the I2C bus from the register map */
+    register_map_init();
+#endif
+
+#if !SENSING_CORE_TELEMETRY
+    /* Start CM4, which subscribes to the readings over the IPC pipe */
+    sensor_ipc_init();
+    Cy_SysEnableCM4(CY_CORTEX_M4_APPL_ADDR);
+#endif
+
+#if ENABLE_LED_DIMMING
+    /* Start the PWM on the LED pin with the LED OFF */
+    led_dimmer_init();
+#else
     /* Configure the LED pin */
     result = cyhal_gpio_init(CYBSP_USER_LED2, CYHAL_GPIO_DIR_OUTPUT , CYHAL_GPIO_DRIVE_STRONG, CYBSP_LED_STATE_OFF);
 
@@ -204,82 +386,418 @@ int main(void)
     {
         CY_ASSERT(0);
     }
+#endif
+
+#if ENABLE_ALS_RANGE_WAKE
+    /* Lower the scan rate and wait for the light to drop below the low
+     * threshold */
+    als_range_init();
+    als_range_arm(false);
+#endif
+
+#if ENABLE_HW_AVERAGE
+    /* Average every channel in the SAR sequencer at a lower scan rate; this
+     * starts the timer */
+    if(!hw_average_set(&hw_average_oversample_config))
+    {
+        CY_ASSERT(0);
+    }
+#endif
+
+#if ENABLE_WARM_RESTART
+    /* Load the filters with the outputs retained before the reset and start
+     * the watchdog */
+    warm_restart_start();
+#endif
 
     /* Enable the global interrupt */
     __enable_irq();
 
+#if ENABLE_SCAN_WINDOWS
+    /* Switch the sensor dividers off; the window timer enables the timer
+     * for EXCITATION_SCANS scans every EXCITATION_PERIOD_MS */
+    excitation_init();
+#else
     /* Enable the timer to start the sampling process  */
     /* Using the device configurator, trigger interval from the timer is
     * set to 2.5ms which results in effective scan rate of 400sps for the SAR ADC.
     */
     Cy_SysAnalog_TimerEnable(PASS);
+#endif
 
     for (;;)
     {
+#if !SENSING_CORE_TELEMETRY
+        /* Put the device to deep-sleep mode. Device wakes up with the level interrupt from FIFO.
+           System Deep Sleep is entered once CM4 is in deep sleep too. */
+        (void)power_manager_sleep();
+#elif ENABLE_ASYNC_TELEMETRY
+        /* Put the device to deep-sleep mode. Device wakes up with the level interrupt from FIFO.
+           With the effective scan rate of 400sps, level count of 120 and 3 channels, device
+           wakes up every 120/(400*3) seconds, that is, 100ms. In DMA mode, the readings are
+           processed only once per FIFO_DMA_LEVELS_PER_BUFFER wake-ups.
+           While a client of the power manager, such as a UART transfer, is busy, the CPU
+           sleeps till the next interrupt instead. */
+        (void)power_manager_sleep();
+#else
         /* Wait till printf completes the UART transfer */
+        CYCLE_PROFILE_START(CYCLE_PROFILE_UART_WAIT);
         while(cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj) == true);
+        CYCLE_PROFILE_STOP(CYCLE_PROFILE_UART_WAIT);
 
         /* Put the device to deep-sleep mode. Device wakes up with the level interrupt from FIFO.
            With the effective scan rate of 400sps, level count of 120 and 3 channels, device
-           wakes up every 120/(400*3) seconds, that is, 100ms. */
-        Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+           wakes up every 120/(400*3) seconds, that is, 100ms. In DMA mode, the readings are
+           processed only once per FIFO_DMA_LEVELS_PER_BUFFER wake-ups.
+           While a client of the power manager, such as the LED dimmer, is busy, the CPU
+           sleeps till the next interrupt instead. */
+        (void)power_manager_sleep();
+#endif
+
+#if ENABLE_ALS_RANGE_WAKE
+        /* Check if the interrupt is a threshold crossing of the ALS channel */
+        range_event = als_range_get_event();
+#endif
 
         /* Check if the interrupt is from the FIFO */
-        if(fifo_intr_flag)
+        if(fifo_intr_flag || range_event)
         {
+            CYCLE_PROFILE_START(CYCLE_PROFILE_WAKE);
+
+#if ENABLE_ALS_RANGE_WAKE
+            level_event = fifo_intr_flag;
+            led_was_on = ((reading.flags & TELEMETRY_FLAG_LED_ON) != 0U);
+#endif
+
             /* Clear the flag */
             fifo_intr_flag = false;
 
+#if ENABLE_FIFO_DMA
+            /* DMA does not run in deep sleep; let it move the FIFO contents to RAM */
+            fifo_dma_wait_idle();
+
+            /* Process the data only when one half of the DMA buffer is full */
+            if(!fifo_dma_is_buffer_ready())
+            {
+                CYCLE_PROFILE_STOP(CYCLE_PROFILE_WAKE);
+                continue;
+            }
+
+            data_count = FIFO_DMA_BUFFER_ENTRIES;
+#elif ENABLE_SAMPLE_RING
+            /* The FIFO interrupt moved the entries into the ring */
+            data_count = (uint16)sample_ring_get_count();
+#else
             /* Check how many entries to be read. Should be equal to (LEVEL+1) when level
              * interrupt is enabled */
             data_count = Cy_SAR_FifoGetDataCount(SAR0);
+#endif
+
+#if ENABLE_ALS_RANGE_WAKE
+            /* A range detection wake-up finds a partly filled FIFO */
+            fifo_count = data_count;
+#endif
 
-            /* Take all the readings from the FIFO and feed through IIR Filter */
+            /* Take all the readings from the FIFO and sort them by channel */
+            CYCLE_PROFILE_START(CYCLE_PROFILE_FIFO_DRAIN);
             while(data_count > 0)
             {
                 data_count--;
 
                 /* Read the FIFO */
+#if ENABLE_FIFO_DMA
+                fifo_dma_read(&fifo_data);
+#elif ENABLE_SAMPLE_RING
+                sample_ring_read(&fifo_data);
+#else
                 Cy_SAR_FifoRead(SAR0, &fifo_data);
-
-                /* If it is the first time reading the data, initialize the IIR filter
-                 * variable and result variable */
-                if(first_run[fifo_data.channel] == true)
-                {
-                    filtered_data[fifo_data.channel] = fifo_data.value;
-                    filt_var[fifo_data.channel] = fifo_data.value << 8;
-
-                    /* Clear the flag */
-                    first_run[fifo_data.channel] = false;
-                }
-                else /* Push the data to the IIR filter */
-                    filtered_data[fifo_data.channel] = low_pass_filter((int16)fifo_data.value, fifo_data.channel);
+#endif
+
+#if ENABLE_FIFO_MONITOR
+                /* Count the entries missing from the channel sequence */
+                fifo_monitor_check((uint8)fifo_data.channel);
+#endif
+
+#if ENABLE_FIFO_CAPTURE
+                /* Pack the entry into the capture frame */
+                fifo_capture_add((uint8)fifo_data.channel, (uint16)fifo_data.value);
+#endif
+
+                /* Add the data to the block of its channel */
+                filter_bank_push((uint8)fifo_data.channel, (int16)fifo_data.value);
+
+#if ENABLE_ALS_RANGE_WAKE
+                /* Keep the result the range detection compared last */
+                if(fifo_data.channel == ALS_SENSOR_CHANNEL)
+                    als_latest = (int32)fifo_data.value;
+#endif
             }
 
-            /* Calculate the temperature value */
-            temperature = get_temperature(filtered_data[THERMISTOR_SENSOR_CHANNEL], filtered_data[REF_RESISTOR_CHANNEL]);
-
-            /* Calculate the ambient light intensity in percentage */
-            light_intensity = get_light_intensity(filtered_data[ALS_SENSOR_CHANNEL]);
-
+#if ENABLE_FIFO_CAPTURE
+            /* Send the entries of this wake-up */
+            fifo_capture_send();
+#endif
+            CYCLE_PROFILE_STOP(CYCLE_PROFILE_FIFO_DRAIN);
+
+#if ENABLE_BURST_MODE
+            /* The burst is read; keep the analog blocks off till the next one */
+            excitation_power_down();
+#endif
+
+            /* Feed the block of each channel through its filter; in burst mode,
+             * average the burst of each channel */
+            CYCLE_PROFILE_START(CYCLE_PROFILE_FILTER);
+            pipeline_filter(filtered_data);
+            CYCLE_PROFILE_STOP(CYCLE_PROFILE_FILTER);
+
+#if ENABLE_FIFO_DMA
+            /* Hand the buffer back to the DMA */
+            fifo_dma_release_buffer();
+#endif
+
+            /* Calculate the temperature, the ambient light intensity and the
+             * outputs of the other sensors */
+            CYCLE_PROFILE_START(CYCLE_PROFILE_CONVERSION);
+            sensor_table_convert(filtered_data, sensor_values);
+
+#if ENABLE_ALS_RANGE_WAKE
+            /* Compare the result seen by the range detection rather than the
+             * filtered one, which lags the crossing */
+            led_light_intensity = get_light_intensity(als_latest);
+#else
+            led_light_intensity = (uint8)sensor_values[SENSOR_LIGHT_INDEX];
+#endif
+            CYCLE_PROFILE_STOP(CYCLE_PROFILE_CONVERSION);
+
+#if ENABLE_LED_DIMMING
+            /* Follow the light with the LED brightness */
+            if(led_dimmer_update(led_light_intensity))
+                reading.flags |= TELEMETRY_FLAG_LED_ON;
+            else
+                reading.flags &= (uint8)~TELEMETRY_FLAG_LED_ON;
+#else
             /* Control the LED */
-            if(light_intensity < ALS_LOW_THRESHOLD)
+            if(led_light_intensity < ALS_LOW_THRESHOLD)
+            {
                 cyhal_gpio_write(CYBSP_USER_LED2, CYBSP_LED_STATE_ON);
+                reading.flags |= TELEMETRY_FLAG_LED_ON;
+            }
             else
-            if(light_intensity > ALS_HIGH_THRESHOLD)
+            if(led_light_intensity > ALS_HIGH_THRESHOLD)
+            {
                 cyhal_gpio_write(CYBSP_USER_LED2, CYBSP_LED_STATE_OFF);
+                reading.flags &= (uint8)~TELEMETRY_FLAG_LED_ON;
+            }
+#endif
+
+#if ENABLE_ALS_RANGE_WAKE
+            /* Wait for the opposite threshold once the LED is switched, and
+             * re-arm at every periodic wake-up. A crossing that did not hold
+             * till the FIFO was read leaves the detection disarmed till the
+             * next periodic wake-up, which limits the wake-up rate while the
+             * light stays close to a threshold. */
+            if(level_event || (led_was_on != ((reading.flags & TELEMETRY_FLAG_LED_ON) != 0U)))
+                als_range_arm((reading.flags & TELEMETRY_FLAG_LED_ON) != 0U);
+#endif
+
+#if ENABLE_ADAPTIVE_RATE
+            /* Period of the wake-up just processed */
+            wake_period_ms = adaptive_rate_get_wake_period_ms();
+
+            /* Lower or restore the scan rate depending on the signal activity */
+            adaptive_rate_update(filtered_data);
+
+            if(adaptive_rate_is_slow())
+                reading.flags |= TELEMETRY_FLAG_SLOW_RATE;
+            else
+                reading.flags &= (uint8)~TELEMETRY_FLAG_SLOW_RATE;
+#elif ENABLE_ALS_RANGE_WAKE
+            /* Period of the wake-up just processed */
+            wake_period_ms = als_range_get_period_ms(fifo_count);
+#elif ENABLE_HW_AVERAGE
+            wake_period_ms = hw_average_get_wake_period_ms();
+#elif ENABLE_SCAN_WINDOWS
+            wake_period_ms = EXCITATION_PERIOD_MS;
+#else
+            wake_period_ms = WAKE_PERIOD_MS;
+#endif
+
+#if ENABLE_FIFO_MONITOR
+            /* Flag the readings computed from incomplete data */
+            if(fifo_monitor_take_loss())
+                reading.flags |= TELEMETRY_FLAG_SAMPLE_LOSS;
+            else
+                reading.flags &= (uint8)~TELEMETRY_FLAG_SAMPLE_LOSS;
+#endif
+
+#if ENABLE_SAMPLE_RING
+            /* The ring holds more than one FIFO level if the previous wake-up
+             * was processed late */
+            wake_period_ms *= sample_ring_take_level_count();
+#endif
+
+            /* Only counted when the time base has no timer */
+            timebase_advance(wake_period_ms);
+
+            /* Collect the reading of this wake-up */
+            wall_ms = timebase_get_wall_ms();
+            reading.timestamp_ms = (uint32)timebase_get_uptime_ms();
+            reading.time_of_day_ms = (uint32)(wall_ms % TIMEBASE_MS_PER_DAY);
+            reading.temperature = sensor_values[SENSOR_TEMPERATURE_INDEX];
+            reading.light_intensity = (uint8)sensor_values[SENSOR_LIGHT_INDEX];
+
+#if ENABLE_REGISTER_MAP
+            /* Store the reading in the registers; the host reads them without
+             * any further processing */
+            register_map_update(&reading, filtered_data);
+#endif
+
+#if !SENSING_CORE_TELEMETRY
+            /* Hand the reading over to CM4; nothing is sent till CM4
+             * subscribes, and then only at the interval it requested */
+            (void)sensor_ipc_publish(&reading);
+#else
+#if ENABLE_TREND_ALARMS
+            /* Sample the outputs at every TREND_SAMPLE_PERIOD_MS boundary, so
+             * that the slope is fitted over evenly spaced samples whatever the
+             * wake-up period */
+            if(timebase_report_due(&trend_due_ms, TREND_SAMPLE_PERIOD_MS))
+                trend_update(sensor_values, &reading);
+#endif
+
+#if ENABLE_HOST_COMMANDS
+            /* Check for a command from the host */
+            host_command = 0;
+
+            if(cyhal_uart_readable(&cy_retarget_io_uart_obj) > 0)
+                (void)cyhal_uart_getc(&cy_retarget_io_uart_obj, &host_command, 0);
+
+#if ENABLE_CYCLE_PROFILE
+            /* Print the cycle counts on request */
+            if(host_command == CYCLE_PROFILE_REPORT_REQUEST)
+            {
+                telemetry_wait_idle();
+                cycle_profile_report();
+                filter_bank_benchmark();
+            }
+#endif
 
-            /* Send over UART every 500ms */
-            if(display_delay == 4)
+#if ENABLE_FIFO_CAPTURE
+            /* Start or stop the capture on request */
+            if(host_command == FIFO_CAPTURE_TOGGLE_REQUEST)
             {
-                /* Print the temperature and the ambient light value*/
-                printf("Temperature: %2.1fC    Ambient Light: %d%%\r\n", temperature, light_intensity);
+                if(fifo_capture_is_active())
+                    fifo_capture_stop();
+                else
+                    fifo_capture_start();
+            }
+#endif
+
+            /* Set the wall-clock time on request */
+            if(host_command == TIMEBASE_SET_REQUEST)
+                (void)timebase_receive_wall_time();
 
-                /* Clear the counter */
-                display_delay = false;
+#if ENABLE_CALIBRATION
+            /* Add a calibration point at the current reading on request */
+            if((host_command == CALIBRATION_THERMISTOR_REQUEST) || (host_command == CALIBRATION_LIGHT_REQUEST))
+            {
+                telemetry_wait_idle();
+
+#if ENABLE_ALS_RANGE_WAKE
+                if(calibration_receive_point(host_command, filtered_data))
+                    als_range_set_limits();
+#else
+                (void)calibration_receive_point(host_command, filtered_data);
+#endif
+            }
+#endif
+
+#if ENABLE_FLASH_LOG
+            /* Start the upload of the log on request */
+            if(host_command == FLASH_LOG_UPLOAD_REQUEST)
+                (void)flash_log_receive_upload();
+#endif
+
+#if ENABLE_TREND_ALARMS
+            /* Print the statistics and the state of the rules on request */
+            if(host_command == TREND_REPORT_REQUEST)
+            {
+                telemetry_wait_idle();
+                trend_report();
             }
-            else /* Increment the counter */
-                display_delay++;
+#endif
+
+#if ENABLE_FIFO_MONITOR
+            /* Print the loss counters on request */
+            if(host_command == FIFO_MONITOR_REPORT_REQUEST)
+            {
+                telemetry_wait_idle();
+                fifo_monitor_report();
+            }
+#endif
+#endif /* ENABLE_HOST_COMMANDS */
+
+#if ENABLE_SAMPLE_LOG
+            /* Log every reading and send the log in one burst at the watermark
+             * or when the host requests it */
+            log_flush = sample_log_add(&reading);
+
+#if ENABLE_HOST_COMMANDS
+            if(host_command == SAMPLE_LOG_FLUSH_REQUEST)
+                log_flush = true;
+#endif
+
+            if(log_flush)
+                (void)sample_log_flush();
+#else
+            /* Send over UART at every 500ms boundary of the wall-clock time; the
+             * UART is kept for the frames while the FIFO is captured or the
+             * flash log is uploaded, one row per wake-up, and only carries the
+             * alarm events unless DISPLAY_REPORTS */
+#if ENABLE_FIFO_CAPTURE
+            if(DISPLAY_REPORTS && timebase_report_due(&display_due_ms, DISPLAY_PERIOD_MS) && !fifo_capture_is_active())
+#elif ENABLE_FLASH_LOG
+            if(!flash_log_upload() && DISPLAY_REPORTS && timebase_report_due(&display_due_ms, DISPLAY_PERIOD_MS))
+#else
+            if(DISPLAY_REPORTS && timebase_report_due(&display_due_ms, DISPLAY_PERIOD_MS))
+#endif
+            {
+                /* Format the temperature and the ambient light value */
+                display_length = telemetry_format(display_line, &reading);
+
+                /* Send the temperature and the ambient light value */
+                (void)telemetry_write(display_line, display_length);
+            }
+#endif
+
+#if ENABLE_FLASH_LOG
+            /* Log a reading at every FLASH_LOG_INTERVAL_MS boundary; a full row
+             * is programmed here, after the FIFO has been drained */
+            if(timebase_report_due(&flash_log_due_ms, FLASH_LOG_INTERVAL_MS))
+                flash_log_add(&reading);
+#endif
+
+#if ENABLE_TREND_ALARMS
+            /* Send a pending alarm event once the UART is free; the events wait
+             * while the FIFO is captured or the flash log is uploaded */
+#if ENABLE_FIFO_CAPTURE
+            if(!fifo_capture_is_active())
+                (void)trend_send_event();
+#elif ENABLE_FLASH_LOG
+            if(!flash_log_is_uploading())
+                (void)trend_send_event();
+#else
+            (void)trend_send_event();
+#endif
+#endif
+#endif /* !SENSING_CORE_TELEMETRY */
+
+#if ENABLE_WARM_RESTART
+            /* Retain the filter outputs of this wake-up and kick the watchdog */
+            warm_restart_update(filtered_data);
+#endif
+
+            CYCLE_PROFILE_STOP(CYCLE_PROFILE_WAKE);
         }
     }
 }
@@ -326,13 +844,25 @@ void init_analog_resources()
     Cy_SysAnalog_LpOscEnable(PASS);
 
     /* Initialize the SAR ADC; it includes initialization of FIFO */
+#if ENABLE_FIFO_DMA
+    /* FIFO level trigger output is enabled to request the DMA transfer */
+    result = Cy_SAR_Init(SAR0, fifo_dma_get_sar_config(&pass_0_saradc_0_sar_0_config));
+#else
     result = Cy_SAR_Init(SAR0, &pass_0_saradc_0_sar_0_config);
+#endif
 
     if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
 
+#if ENABLE_RATIOMETRIC_THERMISTOR
+    /* Remove the reference resistor channel from the scan and lower the FIFO
+     * level to the same number of scans per wake-up */
+    Cy_SAR_SetChanMask(SAR0, SAR_SCAN_CHANNEL_MASK);
+    APP_SAR_FIFO_LEVEL = SAR_FIFO_LEVEL - 1UL;
+#endif
+
     /* Initialize common resources for SAR ADCs in the pass block.
        Common resources include simultaneous trigger parameters, scan count
        and power up delay */
@@ -346,127 +876,27 @@ void init_analog_resources()
     /* Enable SAR block */
     Cy_SAR_Enable(SAR0);
 
+#if ENABLE_FIFO_DMA
+    /* Initialize the DMA that drains the FIFO */
+    fifo_dma_init();
+#endif
+
     /* Enable the FIFO Level Interrupt mask */
+#if ENABLE_FIFO_MONITOR
+    /* Overflow and underflow interrupts are counted as sample loss */
+    Cy_SAR_SetFifoInterruptMask(SAR0, CY_SAR_INTR_FIFO_LEVEL | FIFO_MONITOR_INTR_MASK);
+#else
     Cy_SAR_SetFifoInterruptMask(SAR0, CY_SAR_INTR_FIFO_LEVEL);
+#endif
 
     /* Configure the interrupt and provide the ISR address. */
     (void)Cy_SysInt_Init(&fifo_irq_cfg, sar_fifo_interrupt_handler);
 
     /* Enable the interrupt. */
-    NVIC_EnableIRQ(fifo_irq_cfg.intrSrc);
+    NVIC_EnableIRQ(APP_NVIC_IRQN(pass_interrupt_fifo_0_IRQn, FIFO_IRQ_CM0P_LINE));
 }
 
 
-/*******************************************************************************
-* Function Name: get_temperature
-********************************************************************************
-* Summary:
-* This function calculates the temperature in degree celsius.
-*
-* Parameters:
-*  ADC results for thermistor and reference resistor voltages
-*
-* Return:
-*  temperature in degree celsius (float)
-*
-*******************************************************************************/
-float get_temperature(int32 therm_count, int32 ref_count)
-{
-    float temperature;
-    float rThermistor;
-
-    /* Calculate the thermistor resistance */
-    rThermistor = therm_count * R_REFERENCE / ref_count;
-
-    /* Calculate the temperature in deg C */
-    temperature = (B_CONSTANT/(logf(rThermistor/R_INFINITY))) + ABSOLUTE_ZERO;
-
-    return(temperature);
-}
-
-/*******************************************************************************
-* Function Name: get_light_intensity
-********************************************************************************
-* Summary:
-* This function calculates the ambient light intensity in terms of percentage.
-*
-* Parameters:
-*  ADC measurement result of the photo-transistor
-*
-* Return:
-*  ambient light intensity in percentage (uint8: 0 - 100)
-*
-*******************************************************************************/
-uint8 get_light_intensity(int32 adc_count)
-{
-    int16 als_level;
-    
-    if(adc_count < 0)
-        adc_count = 0;
-
-    /* Calculate the ambient light intensity in terms of percentage */
-    /* Adjust the shift parameter for the required sensitivity */
-    als_level = ((adc_count * 100)>>10) - ALS_OFFSET;
-
-    /* Limit the values between 0 and 100 */
-    if(als_level > 100)
-        als_level = 100;
-
-    if(als_level < 0)
-        als_level = 0;
-
-    return((uint8)als_level);
-}
-
-/*******************************************************************************
-* Function Name: low_pass_filter
-********************************************************************************
-* Summary:
-* This function implements IIR filter for each SAR channel data. Cut-off frequency
-* is given by  F0 = Fs / (2 * pi * a) where, a is the attenuation constant and Fs
-* is the sample rate, that is, 400 sps.
-*
-* In this function, for thermistor and reference resistor channel, a = 256/160 and
-* cut-off frequency is approximately 40Hz; for ALS, a=256/4, cut-off frequency is
-* approximately 1Hz.
-*
-* Parameters:
-*  Data to be filtered and the data source.
-*
-* Return:
-*  Filtered data
-*
-*******************************************************************************/
-int32 low_pass_filter(int32 input, uint8 data_source)
-{
-    int32 k;
-    input <<= 8;
-
-    switch(data_source)
-    {
-        case THERMISTOR_SENSOR_CHANNEL:
-            filt_var[THERMISTOR_SENSOR_CHANNEL] = filt_var[THERMISTOR_SENSOR_CHANNEL] + (((input-filt_var[THERMISTOR_SENSOR_CHANNEL]) >> 8) * 160);
-            k = (filt_var[THERMISTOR_SENSOR_CHANNEL]>>8) + ((filt_var[THERMISTOR_SENSOR_CHANNEL] & 0x00000080) >> 7);
-        break;
-
-        case REF_RESISTOR_CHANNEL:
-            filt_var[REF_RESISTOR_CHANNEL] = filt_var[REF_RESISTOR_CHANNEL] + (((input-filt_var[REF_RESISTOR_CHANNEL]) >> 8) * 160);
-            k = (filt_var[REF_RESISTOR_CHANNEL]>>8) + ((filt_var[REF_RESISTOR_CHANNEL] & 0x00000080) >> 7);
-        break;
-
-        case ALS_SENSOR_CHANNEL:
-            filt_var[ALS_SENSOR_CHANNEL] = filt_var[ALS_SENSOR_CHANNEL] + (((input-filt_var[ALS_SENSOR_CHANNEL]) >> 8) * 4);
-            k = (filt_var[ALS_SENSOR_CHANNEL]>>8) + ((filt_var[ALS_SENSOR_CHANNEL] & 0x00000080) >> 7);
-        break;
-
-        default:
-            k = 0;
-        break;
-    }
-
-    return k;
-}
-
 /*******************************************************************************
 * Function Name: sar_fifo_interrupt_handler
 ********************************************************************************
@@ -482,11 +912,35 @@ int32 low_pass_filter(int32 input, uint8 data_source)
 *******************************************************************************/
 void sar_fifo_interrupt_handler()
 {
+#if ENABLE_FIFO_MONITOR
+    uint32 status = Cy_SAR_GetFifoInterruptStatusMasked(SAR0);
+
+    /* Count and clear the overflow and underflow events */
+    fifo_monitor_count_events(status);
+    Cy_SAR_ClearFifoInterrupt(SAR0, status);
+
+    /* Nothing to read if the level was not reached */
+    if((status & CY_SAR_INTR_FIFO_LEVEL) == 0UL)
+        return;
+#else
     /* Clear the FIFO interrupt */
     Cy_SAR_ClearFifoInterrupt(SAR0, CY_SAR_INTR_FIFO_LEVEL);
+#endif
+
+#if ENABLE_SCAN_WINDOWS
+    /* The last scan of the window is complete */
+    excitation_end_window();
+#endif
+
+#if ENABLE_SAMPLE_RING
+    /* Empty the FIFO into the ring */
+    sample_ring_fill();
+#endif
 
     /* Set the flag */
     fifo_intr_flag = true;
 }
 
+#endif /* !ENABLE_CM0P_SENSING || (CY_CPU_CORTEX_M0P) */
+
 /* [] END OF FILE */
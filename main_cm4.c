@@ -0,0 +1,210 @@
+/******************************************************************************
+* File Name: main_cm4.c
+*
+* Description: This is the source code of CM4 when the sensing of the PSoC 6
+*              MCU SAR ADC Low-Power Sensing - Thermistor and ALS example runs
+*              on CM0+ (ENABLE_CM0P_SENSING). CM4 receives the readings over the
+*              IPC pipe and sends them over UART.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "app_config.h"
+
+#if ENABLE_CM0P_SENSING && ENABLE_CM4 && (CY_CPU_CORTEX_M4)
+
+#include "telemetry.h"
+#include "power_manager.h"
+#include "sensor_ipc.h"
+
+#if ENABLE_SAMPLE_LOG
+#include "sample_log.h"
+#endif
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Interval at which readings are requested from CM0+. The sample log stores
+ * every reading; otherwise one reading per UART update is enough. */
+#if ENABLE_SAMPLE_LOG
+#define READING_PERIOD_MS                   (1UL)
+#else
+#define READING_PERIOD_MS                   (DISPLAY_PERIOD_MS)
+#endif
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* This is the main function for CM4 CPU. It subscribes to the readings of CM0+
+* and sends them over UART. CM4 stays in deep sleep between two readings.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  int
+*
+*******************************************************************************/
+int main(void)
+{
+    /* Variable to capture return value of functions */
+    cy_rslt_t result;
+
+    /* Reading received from CM0+ */
+    telemetry_reading_t reading;
+
+#if ENABLE_SAMPLE_LOG
+#if ENABLE_HOST_COMMANDS
+    /* Command character received from the host; 0 if none */
+    uint8 host_command;
+#endif
+
+    /* Set when the sample log is to be sent */
+    bool log_flush;
+#else
+    /* Line sent over UART and its length */
+    char display_line[TELEMETRY_BUFFER_SIZE];
+    uint16 display_length;
+#endif
+
+    /* Initialize the device and board peripherals */
+    result = cybsp_init() ;
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Initialize the debug uart */
+    result = cy_retarget_io_init(CYBSP_DEBUG_UART_TX, CYBSP_DEBUG_UART_RX,
+                                     CY_RETARGET_IO_BAUDRATE);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Print message */
+
+    /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
+    printf("\x1b[2J\x1b[;H");
+
+    printf("---------------------------------------------------------------------------\r\n");
+    printf("PSoC 6 MCU: SAR ADC Low-Power Sensing - Thermistor and Ambient Light Sensor\r\n");
+    printf("---------------------------------------------------------------------------\r\n\n");
+    printf("Touch the thermistor and block/increase the light over the ambient light \r\n");
+    printf("sensor to observe change in the readings. \r\n\n");
+
+#if ENABLE_SAMPLE_LOG
+    /* Clear the sample log */
+    sample_log_init();
+#endif
+
+#if ENABLE_ASYNC_TELEMETRY
+    /* Wait till the banner is sent; further output is sent asynchronously */
+    while(cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj) == true);
+
+    telemetry_init();
+#endif
+
+    /* Enable the global interrupt */
+    __enable_irq();
+
+    /* Request the readings from CM0+ */
+    sensor_ipc_init();
+
+    if(!sensor_ipc_subscribe(READING_PERIOD_MS))
+    {
+        CY_ASSERT(0);
+    }
+
+    for (;;)
+    {
+#if ENABLE_ASYNC_TELEMETRY
+        /* Put CM4 to deep-sleep mode till the next reading. While a client of
+           the power manager, such as a UART transfer, is busy, the CPU sleeps
+           till the next interrupt instead. */
+        (void)power_manager_sleep();
+#else
+        /* Wait till printf completes the UART transfer */
+        while(cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj) == true);
+
+        /* Put CM4 to deep-sleep mode till the next reading */
+        Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+#endif
+
+        /* Check if the interrupt brought a reading */
+        if(sensor_ipc_receive(&reading))
+        {
+#if ENABLE_SAMPLE_LOG
+#if ENABLE_HOST_COMMANDS
+            /* Check for a command from the host */
+            host_command = 0;
+
+            if(cyhal_uart_readable(&cy_retarget_io_uart_obj) > 0)
+                (void)cyhal_uart_getc(&cy_retarget_io_uart_obj, &host_command, 0);
+#endif
+
+            /* Log every reading and send the log in one burst at the watermark
+             * or when the host requests it */
+            log_flush = sample_log_add(&reading);
+
+#if ENABLE_HOST_COMMANDS
+            if(host_command == SAMPLE_LOG_FLUSH_REQUEST)
+                log_flush = true;
+#endif
+
+            if(log_flush)
+                (void)sample_log_flush();
+#else
+            /* Format the temperature and the ambient light value */
+            display_length = telemetry_format(display_line, &reading);
+
+            /* Send the temperature and the ambient light value */
+            (void)telemetry_write(display_line, display_length);
+#endif
+        }
+    }
+}
+
+#endif /* ENABLE_CM0P_SENSING && ENABLE_CM4 && (CY_CPU_CORTEX_M4) */
+
+/* [] END OF FILE */
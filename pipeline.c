@@ -0,0 +1,284 @@
+/******************************************************************************
+* File Name: pipeline.c
+*
+* Description: This file contains the processing pipeline of the readings: raw
+*              FIFO entries are sorted into the filter bank, filtered, and
+*              converted by the sensor table. It accesses no peripheral, so a
+*              recorded FIFO stream gives the same outputs as the live one.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "pipeline.h"
+#include "cycle_profile.h"
+
+#if ENABLE_PIPELINE_CHECK
+#include <stdio.h>
+#endif
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Reflected polynomial of the CRC-32 (IEEE 802.3) */
+#define PIPELINE_CRC_POLYNOMIAL             (0xEDB88320UL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32 pipeline_crc32(uint32 crc, int32 value);
+
+/*******************************************************************************
+* Function Name: pipeline_filter
+********************************************************************************
+* Summary:
+* This function filters the samples collected since the last call and copies
+* the filter output of every channel. In burst mode, the output is the mean of
+* the burst.
+*
+* Parameters:
+*  filtered_data: array of FILTER_BANK_CHANNELS entries to receive the outputs
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pipeline_filter(int32 *filtered_data)
+{
+#if ENABLE_BURST_MODE
+    filter_bank_average(filtered_data);
+#else
+    filter_bank_flush(filtered_data);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: pipeline_replay
+********************************************************************************
+* Summary:
+* This function runs the FIFO entries of one wake-up through the pipeline, the
+* way the main loop does for the live FIFO, and adds the filter outputs and
+* the sensor outputs to a CRC-32. Two runs of the same stream from the same
+* filter state give the same checksum whatever the target: the filters and
+* the LUT conversion use integer arithmetic only.
+*
+* The phases are profiled as CYCLE_PROFILE_FIFO_DRAIN, CYCLE_PROFILE_FILTER
+* and CYCLE_PROFILE_CONVERSION when ENABLE_CYCLE_PROFILE is set.
+*
+* Parameters:
+*  fifo_entries: raw FIFO entries (PIPELINE_FIFO_ENTRY)
+*  count: number of entries
+*  values: array of SENSOR_COUNT entries to receive the sensor outputs
+*  crc: checksum of the previous wake-ups; PIPELINE_CRC_INIT for the first one
+*
+* Return:
+*  Checksum including this wake-up
+*
+*******************************************************************************/
+uint32 pipeline_replay(const uint32 *fifo_entries, uint32 count, int32 *values, uint32 crc)
+{
+    int32 filtered_data[FILTER_BANK_CHANNELS] = {0};
+    uint32 i;
+
+    CYCLE_PROFILE_START(CYCLE_PROFILE_FIFO_DRAIN);
+    for(i = 0; i < count; i++)
+    {
+        filter_bank_push((uint8)((fifo_entries[i] & PIPELINE_FIFO_CHANNEL_Msk) >> PIPELINE_FIFO_CHANNEL_Pos),
+                         (int16)(fifo_entries[i] & PIPELINE_FIFO_DATA_Msk));
+    }
+    CYCLE_PROFILE_STOP(CYCLE_PROFILE_FIFO_DRAIN);
+
+    CYCLE_PROFILE_START(CYCLE_PROFILE_FILTER);
+    pipeline_filter(filtered_data);
+    CYCLE_PROFILE_STOP(CYCLE_PROFILE_FILTER);
+
+    CYCLE_PROFILE_START(CYCLE_PROFILE_CONVERSION);
+    sensor_table_convert(filtered_data, values);
+    CYCLE_PROFILE_STOP(CYCLE_PROFILE_CONVERSION);
+
+    for(i = 0; i < FILTER_BANK_CHANNELS; i++)
+        crc = pipeline_crc32(crc, filtered_data[i]);
+
+    for(i = 0; i < SENSOR_COUNT; i++)
+        crc = pipeline_crc32(crc, values[i]);
+
+    return(crc);
+}
+
+#if ENABLE_PIPELINE_CHECK
+/*******************************************************************************
+* Function Name: pipeline_check_stream
+********************************************************************************
+* Summary:
+* This function generates the FIFO entries of the next wake-up of the
+* synthetic stream: a reference channel close to mid scale, a thermistor
+* channel sweeping across the LUT, and a ramp on the other channels, with
+* pseudo-random noise. The host build in scripts/pipeline_host records the
+* stream from the same function.
+*
+* Parameters:
+*  stream: position of the stream; PIPELINE_STREAM_INIT for the first wake-up
+*  fifo_entries: array of PIPELINE_CHECK_SCANS * CHANNEL_COUNT entries to
+*                receive the raw FIFO entries
+*
+* Return:
+*  Number of entries
+*
+*******************************************************************************/
+uint32 pipeline_check_stream(pipeline_stream_t *stream, uint32 *fifo_entries)
+{
+    uint32 count = 0;
+    uint32 i;
+    uint8 channel;
+    int32 value;
+
+    for(i = 0; i < PIPELINE_CHECK_SCANS; i++, stream->scan++)
+    {
+        for(channel = 0; channel < FILTER_BANK_CHANNELS; channel++)
+        {
+            if((SAR_SCAN_CHANNEL_MASK & (1UL << channel)) == 0UL)
+                continue;
+
+            /* Linear congruential generator; noise of -8 to 7 counts */
+            stream->noise = (stream->noise * 1664525UL) + 1013904223UL;
+
+            if(channel == REF_RESISTOR_CHANNEL)
+                value = 1024;
+            else if(channel == THERMISTOR_SENSOR_CHANNEL)
+                value = 256 + (int32)((stream->scan * 3UL) % 1536UL);
+            else
+                value = (int32)((stream->scan * 5UL) % 4096UL);
+
+            value += (int32)(stream->noise >> 28) - 8;
+
+            fifo_entries[count++] = PIPELINE_FIFO_ENTRY(channel, (value < 0) ? 0 : value);
+        }
+    }
+
+    return(count);
+}
+
+/*******************************************************************************
+* Function Name: pipeline_check
+********************************************************************************
+* Summary:
+* This function replays PIPELINE_CHECK_BLOCKS wake-ups of the synthetic stream
+* of pipeline_check_stream. The checksum of the outputs is printed and
+* compared with PIPELINE_CHECK_EXPECTED; with ENABLE_CYCLE_PROFILE, the cycle
+* counts of the replay are printed too and cleared afterwards. The references
+* are generated by the host build in scripts/pipeline_host.
+*
+* The filter bank is loaded from the sensor table before and after the
+* replay, so this function must be called before the filters are retuned.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the checksum matches, or if no reference is known for the build
+*
+*******************************************************************************/
+bool pipeline_check(void)
+{
+    uint32 fifo_entries[PIPELINE_CHECK_SCANS * CHANNEL_COUNT];
+    int32 values[SENSOR_COUNT];
+    pipeline_stream_t stream = PIPELINE_STREAM_INIT;
+    uint32 crc = PIPELINE_CRC_INIT;
+    uint32 block;
+    uint32 count = 0;
+
+    /* Replay from the initial filter state */
+    sensor_table_init();
+
+    for(block = 0; block < PIPELINE_CHECK_BLOCKS; block++)
+    {
+        count = pipeline_check_stream(&stream, fifo_entries);
+        crc = pipeline_replay(fifo_entries, count, values, crc);
+    }
+
+    /* Start the sampling from the initial filter state */
+    sensor_table_init();
+
+    printf("Pipeline check: %u wake-ups of %u FIFO entries, checksum 0x%08lX",
+           (unsigned int)PIPELINE_CHECK_BLOCKS, (unsigned int)count, (unsigned long)crc);
+
+    if(PIPELINE_CHECK_EXPECTED == 0UL)
+        printf(" (no reference)\r\n");
+    else if(crc == PIPELINE_CHECK_EXPECTED)
+        printf(" (pass)\r\n");
+    else
+        printf(" (FAIL, expected 0x%08lX)\r\n", (unsigned long)PIPELINE_CHECK_EXPECTED);
+
+#if ENABLE_CYCLE_PROFILE
+    /* Cycles per wake-up of the replay; the FIFO drain includes the sorting
+     * into the filter bank only */
+    cycle_profile_report();
+    cycle_profile_init();
+#endif
+
+    return((PIPELINE_CHECK_EXPECTED == 0UL) || (crc == PIPELINE_CHECK_EXPECTED));
+}
+#endif /* ENABLE_PIPELINE_CHECK */
+
+/*******************************************************************************
+* Function Name: pipeline_crc32
+********************************************************************************
+* Summary:
+* This function adds a value to a CRC-32, least significant byte first. The
+* caller inverts the final value if the standard CRC-32 is needed.
+*
+* Parameters:
+*  crc: current checksum
+*  value: value to be added
+*
+* Return:
+*  Updated checksum
+*
+*******************************************************************************/
+static uint32 pipeline_crc32(uint32 crc, int32 value)
+{
+    uint32 data = (uint32)value;
+    uint8 bit;
+
+    for(bit = 0; bit < 32U; bit++)
+    {
+        crc = ((crc ^ data) & 1UL) ? ((crc >> 1) ^ PIPELINE_CRC_POLYNOMIAL) : (crc >> 1);
+        data >>= 1;
+    }
+
+    return(crc);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,125 @@
+/******************************************************************************
+* File Name: pipeline.h
+*
+* Description: This file contains the declarations of the processing pipeline:
+*              the filter bank and the sensor conversions fed with raw FIFO
+*              entries, independent of the SAR and the other peripherals.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+#include "filter_bank.h"
+#include "sensor_table.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Fields of a raw FIFO entry, as read from the SAR FIFO_RD_DATA register */
+#define PIPELINE_FIFO_DATA_Msk              (0x0000FFFFUL)
+#define PIPELINE_FIFO_CHANNEL_Pos           (16U)
+#define PIPELINE_FIFO_CHANNEL_Msk           (0x000F0000UL)
+
+/* Raw FIFO entry of a channel and a result */
+#define PIPELINE_FIFO_ENTRY(channel, value) ((((uint32)(channel) << PIPELINE_FIFO_CHANNEL_Pos) & PIPELINE_FIFO_CHANNEL_Msk) | \
+                                             ((uint32)(value) & PIPELINE_FIFO_DATA_Msk))
+
+/* Initial value of the checksum of pipeline_replay */
+#define PIPELINE_CRC_INIT                   (0xFFFFFFFFUL)
+
+/* Wake-ups and scans per wake-up of the synthetic stream of pipeline_check */
+#define PIPELINE_CHECK_BLOCKS               (50U)
+
+#if ENABLE_BURST_MODE
+#define PIPELINE_CHECK_SCANS                (BURST_SCANS)
+#else
+#define PIPELINE_CHECK_SCANS                (SAR_FIFO_LEVEL / CHANNEL_COUNT)
+#endif
+
+/* Checksum of the outputs for the synthetic stream in the default
+ * configuration of the sensor table and the filter bank; 0 if no reference
+ * is known for the build, as with the coefficients of a calibrated device.
+ * Generated with "make reference" in scripts/pipeline_host. */
+#ifndef PIPELINE_CHECK_EXPECTED
+#if !ENABLE_THERMISTOR_LUT || ENABLE_BURST_MODE || ENABLE_CALIBRATION
+#define PIPELINE_CHECK_EXPECTED             (0UL)
+#elif ENABLE_RATIOMETRIC_THERMISTOR
+#define PIPELINE_CHECK_EXPECTED             (0x60A6EC26UL)
+#else
+#define PIPELINE_CHECK_EXPECTED             (0x273E9932UL)
+#endif
+#endif
+
+/* Initial position of the synthetic stream */
+#define PIPELINE_STREAM_INIT                { 0U, 1U }
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Position of the synthetic stream of pipeline_check */
+typedef struct
+{
+    /* Scans generated so far */
+    uint32 scan;
+
+    /* State of the noise generator */
+    uint32 noise;
+} pipeline_stream_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to filter the samples collected since the last call */
+void pipeline_filter(int32 *filtered_data);
+
+/* Function to run one wake-up of a recorded FIFO stream through the pipeline */
+uint32 pipeline_replay(const uint32 *fifo_entries, uint32 count, int32 *values, uint32 crc);
+
+#if ENABLE_PIPELINE_CHECK
+/* Function to generate the FIFO entries of one wake-up of the synthetic stream */
+uint32 pipeline_check_stream(pipeline_stream_t *stream, uint32 *fifo_entries);
+
+/* Function to replay the synthetic stream and check the outputs */
+bool pipeline_check(void);
+#endif
+
+#endif /* PIPELINE_H_ */
+
+/* [] END OF FILE */
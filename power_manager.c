@@ -0,0 +1,281 @@
+/******************************************************************************
+* File Name: power_manager.c
+*
+* Description: This file contains the power manager. The clients of the
+*              application are dispatched from one SysPm deep sleep callback, and
+*              the main loops sleep through power_manager_sleep, which goes to CPU
+*              Sleep without trying deep sleep while a client is busy.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "power_manager.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static cy_en_syspm_status_t power_manager_syspm_callback(cy_stc_syspm_callback_params_t *callback_params,
+                                                         cy_en_syspm_callback_mode_t mode);
+
+static void power_manager_wake(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Registered clients, in the order of registration */
+static const power_manager_client_t *power_manager_clients[POWER_MANAGER_MAX_CLIENTS];
+static uint8 power_manager_count = 0;
+
+/* This flag is set between the before_sleep and the after_wake handlers */
+static bool power_manager_prepared = false;
+
+/* Deep sleep callback; the modes without a client handler are skipped, so
+ * that the SysPm driver does not call it for nothing */
+static cy_stc_syspm_callback_params_t power_manager_syspm_params =
+{
+    .base = NULL,
+    .context = NULL
+};
+
+static cy_stc_syspm_callback_t power_manager_syspm_cb =
+{
+    .callback = power_manager_syspm_callback,
+    .type = CY_SYSPM_DEEPSLEEP,
+    .skipMode = CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL |
+                CY_SYSPM_SKIP_BEFORE_TRANSITION | CY_SYSPM_SKIP_AFTER_TRANSITION,
+    .callbackParams = &power_manager_syspm_params,
+    .prevItm = NULL,
+    .nextItm = NULL,
+    .order = 0
+};
+
+
+/*******************************************************************************
+* Function Name: power_manager_register
+********************************************************************************
+* Summary:
+* This function adds a client to the registry. The SysPm callback is
+* registered with the first client, and the callback modes used by the
+* client are no longer skipped.
+*
+* Parameters:
+*  client: client to be added; it must stay valid
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void power_manager_register(const power_manager_client_t *client)
+{
+    uint32 skip_mode = power_manager_syspm_cb.skipMode;
+
+    if(power_manager_count >= POWER_MANAGER_MAX_CLIENTS)
+    {
+        CY_ASSERT(0);
+        return;
+    }
+
+    if(client->is_ready != NULL)
+        skip_mode &= ~CY_SYSPM_SKIP_CHECK_READY;
+
+    if((client->before_sleep != NULL) || (client->after_wake != NULL))
+    {
+        skip_mode &= ~(CY_SYSPM_SKIP_CHECK_FAIL | CY_SYSPM_SKIP_BEFORE_TRANSITION |
+                       CY_SYSPM_SKIP_AFTER_TRANSITION);
+    }
+
+    power_manager_syspm_cb.skipMode = skip_mode;
+    power_manager_clients[power_manager_count++] = client;
+
+    if(power_manager_count == 1U)
+    {
+        if (!Cy_SysPm_RegisterCallback(&power_manager_syspm_cb))
+        {
+            CY_ASSERT(0);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: power_manager_is_ready
+********************************************************************************
+* Summary:
+* This function asks the clients whether they are ready for deep sleep,
+* stopping at the first busy one.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if no client is busy
+*
+*******************************************************************************/
+bool power_manager_is_ready(void)
+{
+    uint8 index;
+
+    for(index = 0; index < power_manager_count; index++)
+    {
+        if((power_manager_clients[index]->is_ready != NULL) && !power_manager_clients[index]->is_ready())
+            return(false);
+    }
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: power_manager_sleep
+********************************************************************************
+* Summary:
+* This function puts the CPU into deep sleep if every client is ready.
+* Otherwise, or if deep sleep is refused by a callback outside the registry,
+* the CPU waits in CPU Sleep mode for the next interrupt, such as the one of
+* the busy client becoming idle, and the caller tries again. Checking the
+* clients first avoids running all the SysPm callbacks for an entry that is
+* refused. The check and the entry are done with the interrupts masked, so
+* that a client becoming idle just after the check still ends CPU Sleep at
+* once instead of at the next FIFO interrupt; WFI wakes on the pending
+* interrupt, which is served when the interrupts are unmasked.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the CPU was in deep sleep; false if it was in CPU Sleep
+*
+*******************************************************************************/
+bool power_manager_sleep(void)
+{
+    uint32 interrupt_state = Cy_SysLib_EnterCriticalSection();
+    bool deep_sleep = false;
+
+    if(power_manager_is_ready() && (Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT) == CY_SYSPM_SUCCESS))
+        deep_sleep = true;
+    else
+        (void)Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    return(deep_sleep);
+}
+
+/*******************************************************************************
+* Function Name: power_manager_syspm_callback
+********************************************************************************
+* Summary:
+* This function is the deep sleep callback of the registry. It checks the
+* clients in CY_SYSPM_CHECK_READY mode, and calls their before_sleep and
+* after_wake handlers around the transition.
+*
+* Parameters:
+*  callback_params: not used
+*  mode: callback mode
+*
+* Return:
+*  CY_SYSPM_FAIL if a client is busy in CY_SYSPM_CHECK_READY mode,
+*  CY_SYSPM_SUCCESS otherwise
+*
+*******************************************************************************/
+static cy_en_syspm_status_t power_manager_syspm_callback(cy_stc_syspm_callback_params_t *callback_params,
+                                                         cy_en_syspm_callback_mode_t mode)
+{
+    cy_en_syspm_status_t status = CY_SYSPM_SUCCESS;
+    uint8 index;
+
+    (void)callback_params;
+
+    switch(mode)
+    {
+        case CY_SYSPM_CHECK_READY:
+            if(!power_manager_is_ready())
+                status = CY_SYSPM_FAIL;
+            break;
+
+        case CY_SYSPM_BEFORE_TRANSITION:
+            for(index = 0; index < power_manager_count; index++)
+            {
+                if(power_manager_clients[index]->before_sleep != NULL)
+                    power_manager_clients[index]->before_sleep();
+            }
+
+            power_manager_prepared = true;
+            break;
+
+        case CY_SYSPM_CHECK_FAIL:
+        case CY_SYSPM_AFTER_TRANSITION:
+            /* Deep sleep was left, or abandoned by another callback after the
+             * clients were prepared */
+            power_manager_wake();
+            break;
+
+        default:
+            break;
+    }
+
+    return(status);
+}
+
+/*******************************************************************************
+* Function Name: power_manager_wake
+********************************************************************************
+* Summary:
+* This function calls the after_wake handlers in the reverse order of
+* registration if the before_sleep handlers were called.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void power_manager_wake(void)
+{
+    uint8 index = power_manager_count;
+
+    if(!power_manager_prepared)
+        return;
+
+    while(index-- > 0U)
+    {
+        if(power_manager_clients[index]->after_wake != NULL)
+            power_manager_clients[index]->after_wake();
+    }
+
+    power_manager_prepared = false;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,91 @@
+/******************************************************************************
+* File Name: power_manager.h
+*
+* Description: This file contains the declarations of the power manager: the
+*              registry of the deep sleep clients of the application and the
+*              sleep entry of the main loops.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef POWER_MANAGER_H_
+#define POWER_MANAGER_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Maximum number of registered clients */
+#define POWER_MANAGER_MAX_CLIENTS           (4U)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Deep sleep client; a handler that is not needed is NULL */
+typedef struct
+{
+    /* Returns false while the peripheral is busy. A busy peripheral must raise
+     * an interrupt when it becomes idle, which ends the CPU Sleep entered
+     * instead of deep sleep. Called in CY_SYSPM_CHECK_READY mode as well, so
+     * it must have no side effects. */
+    bool (*is_ready)(void);
+
+    /* Puts the idle peripheral into its lowest power state; called in
+     * CY_SYSPM_BEFORE_TRANSITION mode, in the order of registration */
+    void (*before_sleep)(void);
+
+    /* Restores the peripheral; called in CY_SYSPM_AFTER_TRANSITION mode, or
+     * when deep sleep is abandoned after before_sleep, in the reverse order */
+    void (*after_wake)(void);
+} power_manager_client_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to add a client; the first call registers the SysPm callback */
+void power_manager_register(const power_manager_client_t *client);
+
+/* Function to check whether every client is ready for deep sleep */
+bool power_manager_is_ready(void);
+
+/* Function to enter deep sleep, or CPU Sleep while a client is busy */
+bool power_manager_sleep(void);
+
+#endif /* POWER_MANAGER_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,260 @@
+/******************************************************************************
+* File Name: register_map.c
+*
+* Description: This file contains the I2C slave register map. The SCB reads the
+*              registers from RAM on each host read, and the application only
+*              stores the reading of each wake-up.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cyhal.h"
+#include "cybsp.h"
+#include "register_map.h"
+#include "sensor_table.h"
+#include "timebase.h"
+
+#if ENABLE_REGISTER_MAP
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void register_map_event_handler(void *callback_arg, cyhal_i2c_event_t event);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static cyhal_i2c_t register_map_i2c;
+
+/* Registers; read by the SCB interrupt while the main loop updates them */
+static volatile register_map_t register_map;
+
+/* Receives the register offset written by the host */
+static uint8 register_map_offset[2];
+
+/* Wall-clock time of the next history entry */
+static uint64_t register_map_history_due_ms = 0;
+
+#if REGISTER_MAP_DEEP_SLEEP_WAKE
+/* PDL deep sleep callback of the SCB; it enables the wake-up interrupt of the
+ * address match before deep sleep and refuses it during a transfer */
+static cy_stc_syspm_callback_params_t register_map_syspm_params =
+{
+    .base = NULL,
+    .context = NULL
+};
+
+static cy_stc_syspm_callback_t register_map_syspm_cb =
+{
+    .callback = Cy_SCB_I2C_DeepSleepCallback,
+    .type = CY_SYSPM_DEEPSLEEP,
+    .skipMode = 0UL,
+    .callbackParams = &register_map_syspm_params,
+    .prevItm = NULL,
+    .nextItm = NULL,
+    .order = 0
+};
+#endif
+
+
+/*******************************************************************************
+* Function Name: register_map_init
+********************************************************************************
+* Summary:
+* This function starts the I2C slave at REGISTER_MAP_I2C_ADDRESS with the
+* register map as the read buffer. With REGISTER_MAP_DEEP_SLEEP_WAKE, the SCB
+* matches the address on the externally clocked bus in System Deep Sleep; it
+* wakes the device and stretches SCL till the transfer is served.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void register_map_init(void)
+{
+    cy_rslt_t result;
+    cyhal_i2c_cfg_t config =
+    {
+        .is_slave = true,
+        .address = REGISTER_MAP_I2C_ADDRESS,
+        .frequencyhal_hz = REGISTER_MAP_I2C_FREQUENCY_HZ
+    };
+
+    register_map.version = REGISTER_MAP_VERSION;
+    register_map.sensor_count = (SENSOR_COUNT < REGISTER_MAP_SENSORS) ? SENSOR_COUNT : REGISTER_MAP_SENSORS;
+
+    result = cyhal_i2c_init(&register_map_i2c, CYBSP_I2C_SDA, CYBSP_I2C_SCL, NULL);
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    result = cyhal_i2c_configure(&register_map_i2c, &config);
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+#if REGISTER_MAP_DEEP_SLEEP_WAKE
+    /* Same setting as enableWakeFromSleep of the PDL configuration; the SCB
+     * must be disabled while it is changed */
+    Cy_SCB_I2C_Disable(register_map_i2c.base, &register_map_i2c.context);
+    CY_REG32_CLR_SET(SCB_CTRL(register_map_i2c.base), SCB_CTRL_EC_AM_MODE, 1UL);
+    Cy_SCB_I2C_Enable(register_map_i2c.base);
+
+    register_map_syspm_params.base = register_map_i2c.base;
+    register_map_syspm_params.context = &register_map_i2c.context;
+
+    if (!Cy_SysPm_RegisterCallback(&register_map_syspm_cb))
+    {
+        CY_ASSERT(0);
+    }
+#endif
+
+    (void)cyhal_i2c_slave_config_read_buffer(&register_map_i2c, (const uint8 *)&register_map, sizeof(register_map));
+    (void)cyhal_i2c_slave_config_write_buffer(&register_map_i2c, register_map_offset, sizeof(register_map_offset));
+
+    cyhal_i2c_register_callback(&register_map_i2c, register_map_event_handler, NULL);
+    cyhal_i2c_enable_event(&register_map_i2c,
+                           (cyhal_i2c_event_t)(CYHAL_I2C_SLAVE_RD_CMPLT_EVENT | CYHAL_I2C_SLAVE_WR_CMPLT_EVENT),
+                           CYHAL_ISR_PRIORITY_DEFAULT, true);
+}
+
+/*******************************************************************************
+* Function Name: register_map_update
+********************************************************************************
+* Summary:
+* This function stores the reading of a wake-up, and adds it to the history at
+* every REGISTER_MAP_HISTORY_PERIOD_MS boundary of the wall-clock time. The
+* sequence register is odd while the registers are written; a host that reads
+* an odd value, or different values before and after its read, reads again.
+*
+* Parameters:
+*  reading: reading of this wake-up
+*  filtered_data: filter output of each SAR channel
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void register_map_update(const telemetry_reading_t *reading, const int32 *filtered_data)
+{
+    volatile register_map_entry_t *entry;
+    int32 temperature = reading->temperature;
+    uint8 sensor;
+
+    register_map.sequence++;
+
+    register_map.timestamp_ms = reading->timestamp_ms;
+    register_map.time_of_day_ms = reading->time_of_day_ms;
+    register_map.temperature = temperature;
+    register_map.light_intensity = reading->light_intensity;
+    register_map.flags = reading->flags;
+
+    for(sensor = 0; sensor < register_map.sensor_count; sensor++)
+        register_map.filtered[sensor] = filtered_data[sensor_table[sensor].channel];
+
+    if(timebase_report_due(&register_map_history_due_ms, REGISTER_MAP_HISTORY_PERIOD_MS))
+    {
+        /* Temperature is limited to the int16 range, as in the binary frame */
+        if(temperature > INT16_MAX)
+            temperature = INT16_MAX;
+
+        if(temperature < INT16_MIN)
+            temperature = INT16_MIN;
+
+        entry = &register_map.history[register_map.history_head];
+        entry->timestamp_ms = reading->timestamp_ms;
+        entry->temperature = (int16)temperature;
+        entry->light_intensity = reading->light_intensity;
+        entry->flags = reading->flags;
+
+        register_map.history_head = (uint8)((register_map.history_head + 1U) % REGISTER_MAP_HISTORY_SIZE);
+
+        if(register_map.history_count < REGISTER_MAP_HISTORY_SIZE)
+            register_map.history_count++;
+    }
+
+    register_map.sequence++;
+}
+
+/*******************************************************************************
+* Function Name: register_map_event_handler
+********************************************************************************
+* Summary:
+* I2C slave event handler. A write of two bytes sets the offset, little-endian,
+* of the next read; any other write sets it to 0. The offset also returns to 0
+* after each read, so a read without a preceding write starts at the version
+* register.
+*
+* Parameters:
+*  callback_arg: not used
+*  event: I2C slave events
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void register_map_event_handler(void *callback_arg, cyhal_i2c_event_t event)
+{
+    uint32 offset = 0;
+
+    (void)callback_arg;
+
+    if((event & CYHAL_I2C_SLAVE_WR_CMPLT_EVENT) != 0U)
+    {
+        if(Cy_SCB_I2C_SlaveGetWriteTransferCount(register_map_i2c.base, &register_map_i2c.context) == 2UL)
+            offset = (uint32)register_map_offset[0] | ((uint32)register_map_offset[1] << 8);
+
+        if(offset >= sizeof(register_map))
+            offset = 0;
+
+        (void)cyhal_i2c_slave_config_write_buffer(&register_map_i2c, register_map_offset, sizeof(register_map_offset));
+    }
+
+    if((event & (CYHAL_I2C_SLAVE_WR_CMPLT_EVENT | CYHAL_I2C_SLAVE_RD_CMPLT_EVENT)) != 0U)
+    {
+        (void)cyhal_i2c_slave_config_read_buffer(&register_map_i2c, (const uint8 *)&register_map + offset,
+                                                 (uint16)(sizeof(register_map) - offset));
+    }
+}
+#endif /* ENABLE_REGISTER_MAP */
+
+/* [] END OF FILE */
@@ -0,0 +1,127 @@
+/******************************************************************************
+* File Name: register_map.h
+*
+* Description: This file contains the interface of the I2C slave register map.
+*              The latest reading, the filtered counts and a history of readings
+*              are held in RAM in the layout the host reads, so a host read needs
+*              no processing by the application.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef REGISTER_MAP_H_
+#define REGISTER_MAP_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* 7-bit slave address and bus frequency */
+#define REGISTER_MAP_I2C_ADDRESS            (0x24U)
+#define REGISTER_MAP_I2C_FREQUENCY_HZ       (400000UL)
+
+/* Value of the version register; changed with the layout */
+#define REGISTER_MAP_VERSION                (1U)
+
+/* Number of filtered count registers, in the order of the sensor table */
+#define REGISTER_MAP_SENSORS                (4U)
+
+/* Number of entries of the history and interval between two entries */
+#define REGISTER_MAP_HISTORY_SIZE           (32U)
+#define REGISTER_MAP_HISTORY_PERIOD_MS      (1000U)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Entry of the history */
+typedef struct
+{
+    uint32 timestamp_ms;
+    int16 temperature;
+    uint8 light_intensity;
+    uint8 flags;
+} register_map_entry_t;
+
+/* Register map. Every field is naturally aligned, so the structure has no
+ * padding and its memory is the little-endian layout read by the host. */
+typedef struct
+{
+    /* 0x00: REGISTER_MAP_VERSION and number of valid filtered counts */
+    uint8 version;
+    uint8 sensor_count;
+
+    /* 0x02: incremented before and after each update, so it is odd while the
+     * registers are being written */
+    uint16 sequence;
+
+    /* 0x04: timestamp and time of day of the latest reading in ms */
+    uint32 timestamp_ms;
+    uint32 time_of_day_ms;
+
+    /* 0x0C: latest temperature in 0.01 deg C */
+    int32 temperature;
+
+    /* 0x10: latest ambient light intensity in percentage and flags
+     * (TELEMETRY_FLAG_x) */
+    uint8 light_intensity;
+    uint8 flags;
+
+    /* 0x12: number of valid history entries, and entry written next */
+    uint8 history_count;
+    uint8 history_head;
+
+    /* 0x14: filtered counts of the entries of the sensor table */
+    int32 filtered[REGISTER_MAP_SENSORS];
+
+    /* 0x24: history, one entry per REGISTER_MAP_HISTORY_PERIOD_MS */
+    register_map_entry_t history[REGISTER_MAP_HISTORY_SIZE];
+} register_map_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to start the I2C slave */
+void register_map_init(void);
+
+/* Function to update the registers with the reading of a wake-up */
+void register_map_update(const telemetry_reading_t *reading, const int32 *filtered_data);
+
+#endif /* REGISTER_MAP_H_ */
+
+/* [] END OF FILE */
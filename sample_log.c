@@ -0,0 +1,262 @@
+/******************************************************************************
+* File Name: sample_log.c
+*
+* Description: This file contains the on-device sample log. Each reading is stored
+*              as the difference to the previous one, ZigZag and varint encoded, so
+*              that a typical reading takes 4 bytes. Two blocks are used: one is
+*              filled while the other one is sent.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "sample_log.h"
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Log block; the header is written when the burst is sent */
+typedef struct
+{
+    uint8 data[SAMPLE_LOG_BLOCK_SIZE];
+    uint16 length;
+    uint16 count;
+} sample_log_block_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint8 * sample_log_put_varint(uint8 *buffer, uint32 value);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Block being filled and block being sent */
+static sample_log_block_t sample_log_block[2];
+static uint8 sample_log_fill = 0;
+
+/* Previous reading; differences are taken against it */
+static telemetry_reading_t sample_log_last;
+
+/* Readings dropped since the last burst sent because both blocks were in use;
+ * the count is sent in the header of the next burst */
+static uint32 sample_log_dropped = 0;
+
+
+/*******************************************************************************
+* Function Name: sample_log_init
+********************************************************************************
+* Summary:
+* This function clears the log.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sample_log_init(void)
+{
+    sample_log_fill = 0;
+    sample_log_block[0].length = SAMPLE_LOG_HEADER_SIZE;
+    sample_log_block[0].count = 0;
+    sample_log_block[1].length = SAMPLE_LOG_HEADER_SIZE;
+    sample_log_block[1].count = 0;
+    memset(&sample_log_last, 0, sizeof(sample_log_last));
+    sample_log_dropped = 0;
+}
+
+/*******************************************************************************
+* Function Name: sample_log_add
+********************************************************************************
+* Summary:
+* This function adds a reading to the block being filled. Each field is stored
+* as the difference to the previous reading of the same block; the first
+* reading of a block is stored against zero, so that every burst can be decoded
+* on its own.
+*
+* Parameters:
+*  reading: reading to be logged
+*
+* Return:
+*  true if the block has reached the watermark and should be flushed
+*
+*******************************************************************************/
+bool sample_log_add(const telemetry_reading_t *reading)
+{
+    sample_log_block_t *block = &sample_log_block[sample_log_fill];
+    uint8 *p;
+
+    if((block->length + SAMPLE_LOG_MAX_RECORD_SIZE + SAMPLE_LOG_CRC_SIZE) > SAMPLE_LOG_BLOCK_SIZE)
+    {
+        /* Block is full and the other one is still being sent */
+        sample_log_dropped++;
+        return(true);
+    }
+
+    if(block->count == 0)
+        memset(&sample_log_last, 0, sizeof(sample_log_last));
+
+    p = sample_log_encode(&block->data[block->length], reading, &sample_log_last);
+
+    block->length = (uint16)(p - block->data);
+    block->count++;
+    sample_log_last = *reading;
+
+    return(block->length >= SAMPLE_LOG_WATERMARK);
+}
+
+/*******************************************************************************
+* Function Name: sample_log_encode
+********************************************************************************
+* Summary:
+* This function encodes a reading as the difference to the previous one.
+* Signed differences are ZigZag encoded. Record layout:
+*   timestamp delta (varint), temperature delta (ZigZag varint),
+*   light delta (ZigZag varint), flags (varint)
+*
+* Parameters:
+*  buffer: position to write the record to; at least
+*          SAMPLE_LOG_MAX_RECORD_SIZE bytes
+*  reading: reading to be encoded
+*  previous: previous reading; all zero for the first record of a block
+*
+* Return:
+*  Position after the record
+*
+*******************************************************************************/
+uint8 * sample_log_encode(uint8 *buffer, const telemetry_reading_t *reading, const telemetry_reading_t *previous)
+{
+    int32 delta;
+
+    buffer = sample_log_put_varint(buffer, reading->timestamp_ms - previous->timestamp_ms);
+
+    delta = reading->temperature - previous->temperature;
+    buffer = sample_log_put_varint(buffer, ((uint32)delta << 1) ^ (uint32)(delta >> 31));
+
+    delta = (int32)reading->light_intensity - (int32)previous->light_intensity;
+    buffer = sample_log_put_varint(buffer, ((uint32)delta << 1) ^ (uint32)(delta >> 31));
+
+    return(sample_log_put_varint(buffer, reading->flags));
+}
+
+/*******************************************************************************
+* Function Name: sample_log_flush
+********************************************************************************
+* Summary:
+* This function completes the header and CRC of the block being filled, starts
+* sending it in one burst and continues the log in the other block. Burst
+* layout:
+*   sync (0xA6), payload length (2), record count (2), drop count (2),
+*   records, CRC (2)
+* The drop count is the number of readings dropped since the previous burst,
+* saturated at 0xFFFF. Multi-byte fields are little-endian; the CRC is the
+* CRC-16/CCITT-FALSE of all the preceding bytes of the burst.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the burst is started; false if the log is empty or the UART is busy
+*
+*******************************************************************************/
+bool sample_log_flush(void)
+{
+    sample_log_block_t *block = &sample_log_block[sample_log_fill];
+    uint16 payload = block->length - SAMPLE_LOG_HEADER_SIZE;
+    uint16 dropped;
+    uint16 crc;
+
+    if((block->count == 0) || telemetry_is_busy())
+        return(false);
+
+    block->data[0] = SAMPLE_LOG_SYNC;
+    block->data[1] = (uint8)payload;
+    block->data[2] = (uint8)(payload >> 8);
+    block->data[3] = (uint8)block->count;
+    block->data[4] = (uint8)(block->count >> 8);
+
+    dropped = (sample_log_dropped > 0xFFFFUL) ? 0xFFFFU : (uint16)sample_log_dropped;
+    block->data[5] = (uint8)dropped;
+    block->data[6] = (uint8)(dropped >> 8);
+
+    crc = telemetry_crc16(block->data, block->length);
+    block->data[block->length] = (uint8)crc;
+    block->data[block->length + 1] = (uint8)(crc >> 8);
+
+    if(!telemetry_write_buffer(block->data, block->length + SAMPLE_LOG_CRC_SIZE))
+        return(false);
+
+    /* The block is in use by the UART till the transfer is done; the other
+     * block was sent by the previous burst and is free */
+    sample_log_dropped = 0;
+    sample_log_fill ^= 1U;
+    sample_log_block[sample_log_fill].length = SAMPLE_LOG_HEADER_SIZE;
+    sample_log_block[sample_log_fill].count = 0;
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: sample_log_put_varint
+********************************************************************************
+* Summary:
+* This function writes an unsigned value in LEB128 varint format: 7 bits per
+* byte, least significant group first, bit 7 set on all but the last byte.
+*
+* Parameters:
+*  buffer: position to write the value to
+*  value: value to be written
+*
+* Return:
+*  Position after the last byte
+*
+*******************************************************************************/
+static uint8 * sample_log_put_varint(uint8 *buffer, uint32 value)
+{
+    while(value >= 0x80UL)
+    {
+        *buffer++ = (uint8)(value | 0x80UL);
+        value >>= 7;
+    }
+
+    *buffer++ = (uint8)value;
+
+    return(buffer);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,94 @@
+/******************************************************************************
+* File Name: sample_log.h
+*
+* Description: This file contains the interface of the on-device sample log. Readings
+*              are delta and varint encoded into RAM blocks that are sent over UART
+*              in one burst.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SAMPLE_LOG_H_
+#define SAMPLE_LOG_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Size of each of the two log blocks in bytes */
+#ifndef SAMPLE_LOG_BLOCK_SIZE
+#define SAMPLE_LOG_BLOCK_SIZE               (512U)
+#endif
+
+/* Burst header: sync, payload length (2), record count (2), drop count (2);
+ * trailer: CRC (2) */
+#define SAMPLE_LOG_SYNC                     (0xA6U)
+#define SAMPLE_LOG_HEADER_SIZE              (7U)
+#define SAMPLE_LOG_CRC_SIZE                 (2U)
+
+/* Largest encoded record: timestamp delta (5), temperature delta (5), light
+ * delta (2) and flags (2) */
+#define SAMPLE_LOG_MAX_RECORD_SIZE          (14U)
+
+/* Fill level of the block, in bytes, at which a burst is requested */
+#ifndef SAMPLE_LOG_WATERMARK
+#define SAMPLE_LOG_WATERMARK                (SAMPLE_LOG_BLOCK_SIZE - SAMPLE_LOG_CRC_SIZE - (2U * SAMPLE_LOG_MAX_RECORD_SIZE))
+#endif
+
+/* Character sent by the host to request a burst */
+#define SAMPLE_LOG_FLUSH_REQUEST            ('F')
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to clear the log */
+void sample_log_init(void);
+
+/* Function to add a reading to the log */
+bool sample_log_add(const telemetry_reading_t *reading);
+
+/* Function to encode a reading as the difference to the previous one */
+uint8 * sample_log_encode(uint8 *buffer, const telemetry_reading_t *reading, const telemetry_reading_t *previous);
+
+/* Function to send the readings collected so far in one burst */
+bool sample_log_flush(void);
+
+#endif /* SAMPLE_LOG_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,248 @@
+/******************************************************************************
+* File Name: sample_ring.c
+*
+* Description: This file contains the single-producer, single-consumer ring
+*              between the FIFO interrupt and the main loop. The interrupt
+*              empties the SAR FIFO into the ring and only advances the head;
+*              the main loop reads from the tail and only advances the tail,
+*              so no critical section is needed on either side.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "sample_ring.h"
+
+#if ENABLE_SAMPLE_RING
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Fields of a SAR FIFO entry */
+#define SAMPLE_RING_RESULT_MASK             (0x0000FFFFUL)
+#define SAMPLE_RING_CHAN_ID_POS             (16UL)
+#define SAMPLE_RING_CHAN_ID_MASK            (0x000F0000UL)
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* FIFO entries as read from the FIFO */
+static uint32 sample_ring_buffer[SAMPLE_RING_SIZE];
+
+/* Free-running indices; the head is written by the interrupt only and the
+ * tail by the main loop only. Entries are at index & SAMPLE_RING_INDEX_MASK. */
+static volatile uint32 sample_ring_head = 0;
+static volatile uint32 sample_ring_tail = 0;
+
+/* Statistics updated by the interrupt */
+static volatile uint32 sample_ring_level_count = 0;
+static volatile uint32 sample_ring_overflow_count = 0;
+static volatile uint32 sample_ring_high_watermark = 0;
+
+/* Level count at the last call of sample_ring_take_level_count */
+static uint32 sample_ring_level_taken = 0;
+
+
+/*******************************************************************************
+* Function Name: sample_ring_init
+********************************************************************************
+* Summary:
+* This function empties the ring and clears the statistics. It must be called
+* before the FIFO interrupt is enabled.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sample_ring_init(void)
+{
+    sample_ring_head = 0;
+    sample_ring_tail = 0;
+    sample_ring_level_count = 0;
+    sample_ring_overflow_count = 0;
+    sample_ring_high_watermark = 0;
+    sample_ring_level_taken = 0;
+}
+
+/*******************************************************************************
+* Function Name: sample_ring_fill
+********************************************************************************
+* Summary:
+* This function moves every entry of the SAR FIFO into the ring. Entries that
+* do not fit are read and dropped, so the FIFO never overflows, and are counted
+* in overflow_count. The head is published once all the entries are stored.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sample_ring_fill(void)
+{
+    uint32 head = sample_ring_head;
+    uint32 tail = sample_ring_tail;
+    uint32 count = Cy_SAR_FifoGetDataCount(SAR0);
+    uint32 entry;
+
+    while(count > 0UL)
+    {
+        count--;
+
+        entry = APP_SAR_FIFO_RD_DATA;
+
+        if((head - tail) < SAMPLE_RING_SIZE)
+        {
+            sample_ring_buffer[head & SAMPLE_RING_INDEX_MASK] = entry;
+            head++;
+        }
+        else
+        {
+            sample_ring_overflow_count++;
+        }
+    }
+
+    /* Make the entries visible before the head */
+    __DMB();
+    sample_ring_head = head;
+
+    if((head - tail) > sample_ring_high_watermark)
+        sample_ring_high_watermark = head - tail;
+
+    sample_ring_level_count++;
+}
+
+/*******************************************************************************
+* Function Name: sample_ring_get_count
+********************************************************************************
+* Summary:
+* This function returns the number of entries waiting in the ring. The entries
+* can be read without checking the count again.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of entries
+*
+*******************************************************************************/
+uint32 sample_ring_get_count(void)
+{
+    uint32 count = sample_ring_head - sample_ring_tail;
+
+    /* Read the entries only after the head */
+    __DMB();
+
+    return(count);
+}
+
+/*******************************************************************************
+* Function Name: sample_ring_read
+********************************************************************************
+* Summary:
+* This function returns the entry at the tail of the ring and frees it. It
+* must only be called for the entries counted by sample_ring_get_count.
+*
+* Parameters:
+*  fifo_data: structure to receive the result and the channel of the entry
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sample_ring_read(cy_stc_sar_fifo_read_t *fifo_data)
+{
+    uint32 tail = sample_ring_tail;
+    uint32 entry = sample_ring_buffer[tail & SAMPLE_RING_INDEX_MASK];
+
+    fifo_data->value = (uint16)(entry & SAMPLE_RING_RESULT_MASK);
+    fifo_data->channel = (uint16)((entry & SAMPLE_RING_CHAN_ID_MASK) >> SAMPLE_RING_CHAN_ID_POS);
+
+    /* Free the entry only after it is read */
+    __DMB();
+    sample_ring_tail = tail + 1UL;
+}
+
+/*******************************************************************************
+* Function Name: sample_ring_take_level_count
+********************************************************************************
+* Summary:
+* This function returns the number of FIFO level interrupts since the last
+* call. It is more than 1 when a wake-up was processed late.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of FIFO level interrupts
+*
+*******************************************************************************/
+uint32 sample_ring_take_level_count(void)
+{
+    uint32 level_count = sample_ring_level_count;
+    uint32 levels = level_count - sample_ring_level_taken;
+
+    sample_ring_level_taken = level_count;
+
+    return(levels);
+}
+
+/*******************************************************************************
+* Function Name: sample_ring_get_stats
+********************************************************************************
+* Summary:
+* This function returns the ring statistics.
+*
+* Parameters:
+*  stats: structure to be filled
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sample_ring_get_stats(sample_ring_stats_t *stats)
+{
+    stats->level_count = sample_ring_level_count;
+    stats->overflow_count = sample_ring_overflow_count;
+    stats->high_watermark = sample_ring_high_watermark;
+}
+
+#endif /* ENABLE_SAMPLE_RING */
+
+/* [] END OF FILE */
@@ -0,0 +1,98 @@
+/******************************************************************************
+* File Name: sample_ring.h
+*
+* Description: This file contains the declarations of the single-producer,
+*              single-consumer ring that the FIFO interrupt fills with the SAR
+*              FIFO entries.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SAMPLE_RING_H_
+#define SAMPLE_RING_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of entries of the ring; a power of 2. 512 entries hold four FIFO
+ * levels, so the processing of a wake-up may take up to 400ms. */
+#define SAMPLE_RING_SIZE                    (512UL)
+#define SAMPLE_RING_INDEX_MASK              (SAMPLE_RING_SIZE - 1UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Ring statistics */
+typedef struct
+{
+    /* Number of FIFO level interrupts */
+    uint32 level_count;
+
+    /* Number of FIFO entries dropped because the ring was full */
+    uint32 overflow_count;
+
+    /* Largest number of entries waiting in the ring */
+    uint32 high_watermark;
+} sample_ring_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to empty the ring */
+void sample_ring_init(void);
+
+/* Function to move the SAR FIFO entries into the ring; called from the FIFO
+ * interrupt */
+void sample_ring_fill(void);
+
+/* Function to get the number of entries waiting in the ring */
+uint32 sample_ring_get_count(void);
+
+/* Function to get the next entry of the ring */
+void sample_ring_read(cy_stc_sar_fifo_read_t *fifo_data);
+
+/* Function to get the number of FIFO level interrupts since the last call */
+uint32 sample_ring_take_level_count(void);
+
+/* Function to get the ring statistics */
+void sample_ring_get_stats(sample_ring_stats_t *stats);
+
+#endif /* SAMPLE_RING_H_ */
+
+/* [] END OF FILE */
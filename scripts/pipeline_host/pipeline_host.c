@@ -0,0 +1,482 @@
+/******************************************************************************
+* File Name: pipeline_host.c
+*
+* Description: Host build of the processing pipeline. Replays the synthetic stream
+*              of pipeline_check or a recorded FIFO stream through the filter bank and
+*              the sensor conversions, with the filter engines of SENSOR_CONFIG or
+*              with one engine on every channel, prints the checksum of the outputs,
+*              generates the references of PIPELINE_CHECK_EXPECTED and measures the
+*              replay time.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pipeline.h"
+#include "filter_bank.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Capacity of a stream file: FIFO entries of a wake-up, and in total */
+#define HOST_MAX_WAKE_ENTRIES               (1024U)
+#define HOST_MAX_ENTRIES                    (262144UL)
+#define HOST_MAX_WAKES                      (8192U)
+
+/* Length of a line of a stream file */
+#define HOST_LINE_SIZE                      (HOST_MAX_WAKE_ENTRIES * 11U)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void host_record_synthetic(void);
+static void host_load_synthetic(void);
+static bool host_load(const char *path);
+static bool host_parse_engine(const char *name, const char *length);
+static uint32 host_replay(void);
+static bool host_report(const char *name, uint32 crc, bool compare);
+static void host_usage(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Stream being replayed: the FIFO entries of all wake-ups and the index of
+ * the first entry of each wake-up */
+static uint32 host_entries[HOST_MAX_ENTRIES];
+static uint32 host_wake_start[HOST_MAX_WAKES + 1U];
+static uint32 host_wakes = 0;
+
+static char host_line[HOST_LINE_SIZE];
+
+/* Filter engine set on every scanned channel by -e; FILTER_ENGINE_COUNT keeps
+ * the engines of SENSOR_CONFIG */
+static filter_engine_t host_engine = FILTER_ENGINE_COUNT;
+static uint8 host_engine_length = 0;
+
+/* Names of the engines accepted by -e */
+static const char * const host_engine_name[FILTER_ENGINE_COUNT] =
+{
+    "iir",
+    "average",
+    "cic",
+    "median"
+};
+
+/* Reference checksum; PIPELINE_CHECK_EXPECTED unless set by -x */
+static uint32 host_expected = PIPELINE_CHECK_EXPECTED;
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* Usage: pipeline_host [-r] [-c] [-x checksum] [-e engine length] [-b iterations] [stream]
+*
+*  -r: print the synthetic stream in the format of a stream file and exit
+*  -c: compare the checksum with PIPELINE_CHECK_EXPECTED of the build
+*  -x: compare with the given checksum instead
+*  -e: run the engine (iir, average, cic or median) with the given window or
+*      order on every scanned channel, through filter_bank_set_engine
+*  -b: replay the stream the given number of times and print the mean time
+*      per wake-up and per FIFO entry
+*  stream: stream file to replay instead of the synthetic stream
+*
+* A stream file holds one wake-up per line, as raw FIFO entries
+* (PIPELINE_FIFO_ENTRY) in hexadecimal separated by spaces. Empty lines and
+* lines starting with '#' are skipped.
+*
+* Return:
+*  0 on success; 1 on a checksum mismatch or an error
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    struct timespec start;
+    struct timespec stop;
+    const char *path = NULL;
+    bool compare = false;
+    unsigned long iterations = 0;
+    unsigned long iteration;
+    uint32 crc;
+    double elapsed_ns;
+    int arg;
+
+    for(arg = 1; arg < argc; arg++)
+    {
+        if(strcmp(argv[arg], "-r") == 0)
+        {
+            host_record_synthetic();
+            return(0);
+        }
+        else if(strcmp(argv[arg], "-c") == 0)
+            compare = true;
+        else if((strcmp(argv[arg], "-x") == 0) && ((arg + 1) < argc))
+            host_expected = (uint32)strtoul(argv[++arg], NULL, 0);
+        else if((strcmp(argv[arg], "-e") == 0) && ((arg + 2) < argc))
+        {
+            if(!host_parse_engine(argv[arg + 1], argv[arg + 2]))
+                return(1);
+
+            arg += 2;
+        }
+        else if((strcmp(argv[arg], "-b") == 0) && ((arg + 1) < argc))
+            iterations = strtoul(argv[++arg], NULL, 0);
+        else if((argv[arg][0] != '-') && (path == NULL))
+            path = argv[arg];
+        else
+        {
+            host_usage();
+            return(1);
+        }
+    }
+
+    if(path == NULL)
+    {
+        host_load_synthetic();
+
+        /* Same replay as on the target, unless the engines are changed */
+        if((host_engine == FILTER_ENGINE_COUNT) && (host_expected == PIPELINE_CHECK_EXPECTED))
+        {
+            if(!pipeline_check() && compare)
+                return(1);
+        }
+        else if(!host_report("synthetic stream", host_replay(), compare))
+            return(1);
+    }
+    else
+    {
+        if(!host_load(path))
+            return(1);
+
+        if(!host_report(path, host_replay(), compare))
+            return(1);
+    }
+
+    if(iterations > 0UL)
+    {
+        (void)clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for(iteration = 0; iteration < iterations; iteration++)
+            crc = host_replay();
+
+        (void)clock_gettime(CLOCK_MONOTONIC, &stop);
+        (void)crc;
+
+        elapsed_ns = ((double)(stop.tv_sec - start.tv_sec) * 1e9) + (double)(stop.tv_nsec - start.tv_nsec);
+
+        printf("Benchmark: %lu replays, %.1f ns per wake-up, %.2f ns per FIFO entry\n", iterations,
+               elapsed_ns / ((double)iterations * (double)host_wakes),
+               elapsed_ns / ((double)iterations * (double)host_wake_start[host_wakes]));
+    }
+
+    return(0);
+}
+
+/*******************************************************************************
+* Function Name: host_record_synthetic
+********************************************************************************
+* Summary:
+* This function prints the PIPELINE_CHECK_BLOCKS wake-ups of the synthetic
+* stream in the format of a stream file.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void host_record_synthetic(void)
+{
+    uint32 fifo_entries[PIPELINE_CHECK_SCANS * CHANNEL_COUNT];
+    pipeline_stream_t stream = PIPELINE_STREAM_INIT;
+    uint32 block;
+    uint32 count;
+    uint32 i;
+
+    printf("# Synthetic stream of pipeline_check: %u wake-ups, SAR channel mask 0x%04lX\n",
+           (unsigned int)PIPELINE_CHECK_BLOCKS, (unsigned long)SAR_SCAN_CHANNEL_MASK);
+
+    for(block = 0; block < PIPELINE_CHECK_BLOCKS; block++)
+    {
+        count = pipeline_check_stream(&stream, fifo_entries);
+
+        for(i = 0; i < count; i++)
+            printf((i == 0U) ? "%05lX" : " %05lX", (unsigned long)fifo_entries[i]);
+
+        printf("\n");
+    }
+}
+
+/*******************************************************************************
+* Function Name: host_load_synthetic
+********************************************************************************
+* Summary:
+* This function keeps the PIPELINE_CHECK_BLOCKS wake-ups of the synthetic
+* stream for host_replay.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void host_load_synthetic(void)
+{
+    pipeline_stream_t stream = PIPELINE_STREAM_INIT;
+
+    host_wake_start[0] = 0;
+
+    for(host_wakes = 0; host_wakes < PIPELINE_CHECK_BLOCKS; host_wakes++)
+    {
+        host_wake_start[host_wakes + 1U] = host_wake_start[host_wakes] +
+            pipeline_check_stream(&stream, &host_entries[host_wake_start[host_wakes]]);
+    }
+}
+
+/*******************************************************************************
+* Function Name: host_load
+********************************************************************************
+* Summary:
+* This function reads a stream file.
+*
+* Parameters:
+*  path: path of the file
+*
+* Return:
+*  true if the file was read
+*
+*******************************************************************************/
+static bool host_load(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    uint32 total = 0;
+    uint32 count;
+    char *p;
+    char *end;
+
+    if(file == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return(false);
+    }
+
+    host_wakes = 0;
+    host_wake_start[0] = 0;
+
+    while(fgets(host_line, sizeof(host_line), file) != NULL)
+    {
+        if((host_line[0] == '#') || (host_line[0] == '\n') || (host_line[0] == '\r'))
+            continue;
+
+        if(host_wakes == HOST_MAX_WAKES)
+        {
+            fprintf(stderr, "%s: more than %u wake-ups\n", path, (unsigned int)HOST_MAX_WAKES);
+            fclose(file);
+            return(false);
+        }
+
+        count = 0;
+
+        for(p = host_line; ; p = end)
+        {
+            unsigned long entry = strtoul(p, &end, 16);
+
+            if(end == p)
+                break;
+
+            if((count == HOST_MAX_WAKE_ENTRIES) || (total == HOST_MAX_ENTRIES))
+            {
+                fprintf(stderr, "%s: too many FIFO entries\n", path);
+                fclose(file);
+                return(false);
+            }
+
+            host_entries[total++] = (uint32)entry;
+            count++;
+        }
+
+        host_wake_start[++host_wakes] = total;
+    }
+
+    fclose(file);
+
+    return(host_wakes > 0U);
+}
+
+/*******************************************************************************
+* Function Name: host_parse_engine
+********************************************************************************
+* Summary:
+* This function reads the engine and the length of the -e option.
+*
+* Parameters:
+*  name: name of the engine in host_engine_name
+*  length: window or order of the engine
+*
+* Return:
+*  true if the engine is known
+*
+*******************************************************************************/
+static bool host_parse_engine(const char *name, const char *length)
+{
+    uint8 engine;
+
+    for(engine = 0; engine < FILTER_ENGINE_COUNT; engine++)
+    {
+        if(strcmp(name, host_engine_name[engine]) == 0)
+        {
+            host_engine = (filter_engine_t)engine;
+            host_engine_length = (uint8)strtoul(length, NULL, 0);
+            return(true);
+        }
+    }
+
+    fprintf(stderr, "Unknown filter engine %s\n", name);
+    return(false);
+}
+
+/*******************************************************************************
+* Function Name: host_replay
+********************************************************************************
+* Summary:
+* This function replays the stream from the initial filter state, one
+* pipeline_replay call per wake-up, as pipeline_check does. The engine of the
+* -e option is set on every scanned channel first; the program exits if the
+* build refuses it, as with ENABLE_STATIC_PIPELINE.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Checksum of the outputs
+*
+*******************************************************************************/
+static uint32 host_replay(void)
+{
+    int32 values[SENSOR_COUNT];
+    uint32 crc = PIPELINE_CRC_INIT;
+    uint32 wake;
+    uint8 channel;
+
+    sensor_table_init();
+
+    for(channel = 0; (host_engine != FILTER_ENGINE_COUNT) && (channel < FILTER_BANK_CHANNELS); channel++)
+    {
+        if((SAR_SCAN_CHANNEL_MASK & (1UL << channel)) == 0UL)
+            continue;
+
+        if(!filter_bank_set_engine(channel, host_engine, host_engine_length))
+        {
+            fprintf(stderr, "Engine %s of length %u refused on channel %u\n", host_engine_name[host_engine],
+                    (unsigned int)host_engine_length, (unsigned int)channel);
+            exit(1);
+        }
+    }
+
+    for(wake = 0; wake < host_wakes; wake++)
+    {
+        crc = pipeline_replay(&host_entries[host_wake_start[wake]],
+                              host_wake_start[wake + 1U] - host_wake_start[wake], values, crc);
+    }
+
+    return(crc);
+}
+
+/*******************************************************************************
+* Function Name: host_report
+********************************************************************************
+* Summary:
+* This function prints the checksum of a replay, and compares it with the
+* reference when requested.
+*
+* Parameters:
+*  name: name of the stream
+*  crc: checksum of the outputs
+*  compare: true to compare with the reference
+*
+* Return:
+*  false on a mismatch
+*
+*******************************************************************************/
+static bool host_report(const char *name, uint32 crc, bool compare)
+{
+    printf("Replay of %s", name);
+
+    if(host_engine != FILTER_ENGINE_COUNT)
+        printf(" (%s %u)", host_engine_name[host_engine], (unsigned int)host_engine_length);
+
+    printf(": %u wake-ups of %lu FIFO entries, checksum 0x%08lX",
+           (unsigned int)host_wakes, (unsigned long)host_wake_start[host_wakes], (unsigned long)crc);
+
+    if(!compare)
+        printf("\n");
+    else if(host_expected == 0UL)
+        printf(" (no reference)\n");
+    else if(crc == host_expected)
+        printf(" (pass)\n");
+    else
+    {
+        printf(" (FAIL, expected 0x%08lX)\n", (unsigned long)host_expected);
+        return(false);
+    }
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: host_usage
+********************************************************************************
+* Summary:
+* This function prints the command line options.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void host_usage(void)
+{
+    fprintf(stderr, "Usage: pipeline_host [-r] [-c] [-x checksum] [-e engine length] [-b iterations] [stream]\n");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+################################################################################
+# File Name: thermistor_lut_gen.py
+#
+# Description: Generates thermistor_lut_table.h, the lookup table used by the
+#              float-free temperature conversion, from the Beta model of the
+#              NCP18XH103F03RB thermistor. Prints an accuracy report of the
+#              table-based conversion against the Beta model.
+#
+# Usage: python3 scripts/thermistor_lut_gen.py [--report-only]
+#
+# Related Document: See README.md
+#
+################################################################################
+# Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+#
+# This software, including source code, documentation and related
+# materials ("Software") is owned by Cypress Semiconductor Corporation
+# or one of its affiliates ("Cypress") and is protected by and subject to
+# worldwide patent protection (United States and foreign),
+# United States copyright laws and international treaty provisions.
+# Therefore, you may use this Software only as provided in the license
+# agreement accompanying the software package from which you
+# obtained this Software ("EULA").
+################################################################################
+
+import math
+import os
+import sys
+
+# Thermistor parameters, same as the macros in main.c
+R_REFERENCE = 10000.0
+B_CONSTANT = 3380.0
+R_INFINITY = 0.1192855
+ABSOLUTE_ZERO = -273.15
+
+# Table range and step in degree C
+T_MIN = -40.0
+T_MAX = 125.0
+T_STEP = 2.5
+
+# Ratio (thermistor count / reference count) is stored in Q16 format
+RATIO_SHIFT = 16
+
+OUTPUT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "thermistor_lut_table.h")
+
+
+def beta_ratio(t):
+    """Resistance ratio R_thermistor / R_reference at temperature t (deg C)."""
+    return R_INFINITY * math.exp(B_CONSTANT / (t - ABSOLUTE_ZERO)) / R_REFERENCE
+
+
+def beta_temperature(ratio):
+    """Temperature in deg C from the ratio, as computed by the float get_temperature()."""
+    return B_CONSTANT / math.log(ratio * R_REFERENCE / R_INFINITY) + ABSOLUTE_ZERO
+
+
+def build_table():
+    count = int(round((T_MAX - T_MIN) / T_STEP)) + 1
+    return [int(round(beta_ratio(T_MIN + i * T_STEP) * (1 << RATIO_SHIFT))) for i in range(count)]
+
+
+def lookup(table, ratio_q16):
+    """Bit-exact model of thermistor_lut_get_temperature() in thermistor_lut.c."""
+    step_centi = int(round(T_STEP * 100))
+    if ratio_q16 >= table[0]:
+        return int(round(T_MIN * 100))
+    if ratio_q16 <= table[-1]:
+        return int(round(T_MAX * 100))
+    low, high = 0, len(table) - 1
+    while (high - low) > 1:
+        mid = (low + high) // 2
+        if table[mid] > ratio_q16:
+            low = mid
+        else:
+            high = mid
+    return (int(round(T_MIN * 100)) + low * step_centi
+            + (step_centi * (table[low] - ratio_q16)) // (table[low] - table[high]))
+
+
+def report(table):
+    print("Accuracy of the table based conversion against the Beta model")
+    print("Entries: %d (%d bytes), step: %.1f C" % (len(table), 4 * len(table), T_STEP))
+    print("")
+    print("  Range (C)       Max error (C)   Mean error (C)")
+    worst = 0.0
+    for start in range(int(T_MIN), int(T_MAX), 15):
+        end = min(start + 15, int(T_MAX))
+        errors = []
+        t = float(start)
+        while t <= end:
+            ratio_q16 = int(beta_ratio(t) * (1 << RATIO_SHIFT))
+            error = lookup(table, ratio_q16) / 100.0 - beta_temperature(ratio_q16 / float(1 << RATIO_SHIFT))
+            errors.append(abs(error))
+            t += 0.01
+        worst = max(worst, max(errors))
+        print("  %4d .. %4d     %6.3f          %6.3f" % (start, end, max(errors), sum(errors) / len(errors)))
+    print("")
+    print("Worst case error over %d .. %d C: %.3f C" % (T_MIN, T_MAX, worst))
+
+
+def write_header(table):
+    lines = []
+    for i in range(0, len(table), 6):
+        lines.append("    " + ", ".join("%7dUL" % v for v in table[i:i + 6]))
+    with open(OUTPUT, "w") as f:
+        f.write("/* Generated by scripts/thermistor_lut_gen.py - do not edit. */\n\n")
+        f.write("#ifndef THERMISTOR_LUT_TABLE_H_\n#define THERMISTOR_LUT_TABLE_H_\n\n")
+        f.write("/* Temperature of the first entry and step between entries in 0.01 deg C */\n")
+        f.write("#define THERMISTOR_LUT_T_MIN_CENTI         (%d)\n" % int(round(T_MIN * 100)))
+        f.write("#define THERMISTOR_LUT_T_STEP_CENTI        (%d)\n\n" % int(round(T_STEP * 100)))
+        f.write("/* Number of entries in the table */\n")
+        f.write("#define THERMISTOR_LUT_ENTRIES             (%d)\n\n" % len(table))
+        f.write("/* Fractional bits of the ratio (thermistor count / reference count) */\n")
+        f.write("#define THERMISTOR_LUT_RATIO_SHIFT         (%d)\n\n" % RATIO_SHIFT)
+        f.write("/* Ratio at each temperature step, from the Beta model: B = %d K, R0 = 10 kohm */\n" % B_CONSTANT)
+        f.write("#define THERMISTOR_LUT_TABLE                                              \\\n{   \\\n")
+        f.write(", \\\n".join(lines))
+        f.write("  \\\n}\n\n#endif /* THERMISTOR_LUT_TABLE_H_ */\n")
+
+
+if __name__ == "__main__":
+    lut = build_table()
+    if "--report-only" not in sys.argv:
+        write_header(lut)
+    report(lut)
@@ -0,0 +1,101 @@
+/******************************************************************************
+* File Name: sensor_config.h
+*
+* Description: This file contains the sensor configuration the processing pipeline
+*              is generated from: the SAR channels, the sensor of each channel and
+*              its filter. The scan mask, the channel and sensor counts, the sensor
+*              table and the specialized filter and conversion code are derived
+*              from the list at compile time.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SENSOR_CONFIG_H_
+#define SENSOR_CONFIG_H_
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Defines for the ADC channels */
+#define THERMISTOR_SENSOR_CHANNEL           (1)
+#define REF_RESISTOR_CHANNEL                (0)
+#define ALS_SENSOR_CHANNEL                  (2)
+
+/* Sensor list, one entry per channel scanned by the SAR sequencer, in the
+ * order of the sensor table:
+ *
+ *   X(name, channel, ref_channel, type, engine, length, coefficient, shift)
+ *
+ *   name: index of the entry, SENSOR_INDEX_<name>
+ *   channel: SAR channel of the sensor
+ *   ref_channel: SAR channel the sensor is measured against
+ *   type: SENSOR_TYPE_<type>, which also selects the conversion
+ *   engine: FILTER_ENGINE_<engine> of the channel
+ *   length: window or order of the engine; not used by the IIR
+ *   coefficient, shift: weight of each new sample, out of 2^shift
+ *
+ * Cut-off frequency of the IIR filter is given by F0 = Fs / (2 * pi * a)
+ * where a = 2^shift / coefficient is the attenuation constant and Fs is the
+ * sample rate, that is, 400 sps. For thermistor and reference resistor
+ * channel, a = 256/160 and cut-off frequency is approximately 40Hz; for ALS,
+ * a = 256/4, cut-off frequency is approximately 1Hz.
+ *
+ * The entries named TEMPERATURE and LIGHT are reported in the telemetry and
+ * used for the LED control. Additional thermistors are added as THERMISTOR
+ * entries with the ref_channel of their reference resistor; the SAR sequencer
+ * in design.modus must scan the channels of the list. */
+#if ENABLE_RATIOMETRIC_THERMISTOR
+#define SENSOR_CONFIG(X) \
+    X(TEMPERATURE, THERMISTOR_SENSOR_CHANNEL, THERMISTOR_SENSOR_CHANNEL, THERMISTOR_RATIOMETRIC, IIR, 0, 160, 8) \
+    X(LIGHT,       ALS_SENSOR_CHANNEL,        ALS_SENSOR_CHANNEL,        ALS,                    IIR, 0,   4, 8)
+#else
+#define SENSOR_CONFIG(X) \
+    X(REFERENCE,   REF_RESISTOR_CHANNEL,      REF_RESISTOR_CHANNEL,      REFERENCE,              IIR, 0, 160, 8) \
+    X(TEMPERATURE, THERMISTOR_SENSOR_CHANNEL, REF_RESISTOR_CHANNEL,      THERMISTOR,             IIR, 0, 160, 8) \
+    X(LIGHT,       ALS_SENSOR_CHANNEL,        ALS_SENSOR_CHANNEL,        ALS,                    IIR, 0,   4, 8)
+#endif
+
+/* Generators of the constants below; usable in preprocessor conditions */
+#define SENSOR_CONFIG_COUNT_ENTRY(name, channel, ...)   + 1
+#define SENSOR_CONFIG_MASK_ENTRY(name, channel, ...)    | (1UL << (channel))
+
+/* Channels scanned by the SAR sequencer and their number */
+#define SAR_SCAN_CHANNEL_MASK               (0UL SENSOR_CONFIG(SENSOR_CONFIG_MASK_ENTRY))
+#define CHANNEL_COUNT                       (0 SENSOR_CONFIG(SENSOR_CONFIG_COUNT_ENTRY))
+
+#endif /* SENSOR_CONFIG_H_ */
+
+/* [] END OF FILE */
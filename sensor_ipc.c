@@ -0,0 +1,301 @@
+/******************************************************************************
+* File Name: sensor_ipc.c
+*
+* Description: This file contains the IPC pipe that passes the readings from
+*              CM0+ to CM4. The system pipe of the PDL is used: CM4 subscribes
+*              with the interval at which it needs readings, and CM0+ sends a
+*              reading only when one is due, so CM4 stays in deep sleep
+*              otherwise.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "sensor_ipc.h"
+
+#if ENABLE_CM0P_SENSING && ENABLE_CM4
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Endpoint of this core and of the other core */
+#define SENSOR_IPC_EP_LOCAL                 ((CY_CPU_CORTEX_M0P) ? CY_IPC_EP_CYPIPE_CM0_ADDR : CY_IPC_EP_CYPIPE_CM4_ADDR)
+#define SENSOR_IPC_EP_REMOTE                ((CY_CPU_CORTEX_M0P) ? CY_IPC_EP_CYPIPE_CM4_ADDR : CY_IPC_EP_CYPIPE_CM0_ADDR)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static bool sensor_ipc_send(uint32 code);
+static void sensor_ipc_callback(uint32 *msg_ptr);
+static void sensor_ipc_release_callback(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Message being sent; owned by the pipe till released by the other core */
+static sensor_ipc_msg_t sensor_ipc_tx_msg;
+static volatile bool sensor_ipc_tx_busy = false;
+
+/* Latest reading received and whether it was read */
+static telemetry_reading_t sensor_ipc_rx_reading;
+static volatile bool sensor_ipc_rx_ready = false;
+
+/* Interval requested by CM4; 0 while no reading is requested */
+static volatile uint32 sensor_ipc_period_ms = 0;
+
+/* Timestamp of the last reading sent and whether one was sent since the
+ * subscription */
+static uint32 sensor_ipc_last_ms = 0;
+static volatile bool sensor_ipc_first = true;
+
+/* Set when a reading was dropped because the previous one was not released;
+ * reported in the flags of the next reading sent */
+static bool sensor_ipc_dropped = false;
+
+
+/*******************************************************************************
+* Function Name: sensor_ipc_init
+********************************************************************************
+* Summary:
+* This function registers the client callback on the system pipe endpoint of
+* this core. The system pipe is initialized by the startup code of both cores.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sensor_ipc_init(void)
+{
+    if (Cy_IPC_Pipe_RegisterCallback(SENSOR_IPC_EP_LOCAL, sensor_ipc_callback,
+                                     SENSOR_IPC_CLIENT_ID) != CY_IPC_PIPE_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sensor_ipc_subscribe
+********************************************************************************
+* Summary:
+* This function requests CM0+ to send a reading every period_ms. Passing 0
+* stops the readings.
+*
+* Parameters:
+*  period_ms: minimum interval between two readings in milliseconds
+*
+* Return:
+*  true if the request was sent
+*
+*******************************************************************************/
+bool sensor_ipc_subscribe(uint32 period_ms)
+{
+    /* Wait till the previous message is released */
+    while(sensor_ipc_tx_busy);
+
+    sensor_ipc_tx_msg.period_ms = period_ms;
+
+    return(sensor_ipc_send(SENSOR_IPC_CODE_SUBSCRIBE));
+}
+
+/*******************************************************************************
+* Function Name: sensor_ipc_publish
+********************************************************************************
+* Summary:
+* This function sends the reading to CM4 if CM4 subscribed and the requested
+* interval has elapsed since the last reading sent. The reading is dropped if
+* CM4 has not released the previous one; TELEMETRY_FLAG_SAMPLE_LOSS is then set
+* in the next reading sent.
+*
+* Parameters:
+*  reading: reading of this wake-up
+*
+* Return:
+*  true if the reading was sent
+*
+*******************************************************************************/
+bool sensor_ipc_publish(const telemetry_reading_t *reading)
+{
+    uint32 period_ms = sensor_ipc_period_ms;
+
+    if(period_ms == 0)
+        return(false);
+
+    if(!sensor_ipc_first && ((reading->timestamp_ms - sensor_ipc_last_ms) < period_ms))
+        return(false);
+
+    if(sensor_ipc_tx_busy)
+    {
+        sensor_ipc_dropped = true;
+        return(false);
+    }
+
+    sensor_ipc_tx_msg.reading = *reading;
+
+    if(sensor_ipc_dropped)
+        sensor_ipc_tx_msg.reading.flags |= TELEMETRY_FLAG_SAMPLE_LOSS;
+
+    if(!sensor_ipc_send(SENSOR_IPC_CODE_READING))
+    {
+        sensor_ipc_dropped = true;
+        return(false);
+    }
+
+    sensor_ipc_dropped = false;
+
+    sensor_ipc_last_ms = reading->timestamp_ms;
+    sensor_ipc_first = false;
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: sensor_ipc_receive
+********************************************************************************
+* Summary:
+* This function returns the latest reading received from CM0+ if it was not
+* read yet.
+*
+* Parameters:
+*  reading: structure to be filled
+*
+* Return:
+*  true if a new reading was copied
+*
+*******************************************************************************/
+bool sensor_ipc_receive(telemetry_reading_t *reading)
+{
+    uint32 interrupt_state;
+
+    if(!sensor_ipc_rx_ready)
+        return(false);
+
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    *reading = sensor_ipc_rx_reading;
+    sensor_ipc_rx_ready = false;
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: sensor_ipc_send
+********************************************************************************
+* Summary:
+* This function sends the message buffer to the other core. The buffer stays
+* owned by the pipe till the release callback runs.
+*
+* Parameters:
+*  code: message code
+*
+* Return:
+*  true if the message was sent
+*
+*******************************************************************************/
+static bool sensor_ipc_send(uint32 code)
+{
+    sensor_ipc_tx_msg.header = _VAL2FLD(CY_IPC_PIPE_MSG_CLIENT, SENSOR_IPC_CLIENT_ID) |
+                               _VAL2FLD(CY_IPC_PIPE_MSG_USR, code);
+    sensor_ipc_tx_busy = true;
+
+    if(Cy_IPC_Pipe_SendMessage(SENSOR_IPC_EP_REMOTE, SENSOR_IPC_EP_LOCAL,
+                               (void *)&sensor_ipc_tx_msg, sensor_ipc_release_callback) != CY_IPC_PIPE_SUCCESS)
+    {
+        sensor_ipc_tx_busy = false;
+        return(false);
+    }
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: sensor_ipc_callback
+********************************************************************************
+* Summary:
+* This function is called from the IPC interrupt of the receiving core. The
+* message is copied since it is released when the callback returns.
+*
+* Parameters:
+*  msg_ptr: message received
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sensor_ipc_callback(uint32 *msg_ptr)
+{
+    const sensor_ipc_msg_t *msg = (const sensor_ipc_msg_t *)msg_ptr;
+
+    switch(_FLD2VAL(CY_IPC_PIPE_MSG_USR, msg->header))
+    {
+        case SENSOR_IPC_CODE_READING:
+            sensor_ipc_rx_reading = msg->reading;
+            sensor_ipc_rx_ready = true;
+            break;
+
+        case SENSOR_IPC_CODE_SUBSCRIBE:
+            sensor_ipc_period_ms = msg->period_ms;
+            sensor_ipc_first = true;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sensor_ipc_release_callback
+********************************************************************************
+* Summary:
+* This function is called on the sending core when the other core released
+* the message.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sensor_ipc_release_callback(void)
+{
+    sensor_ipc_tx_busy = false;
+}
+
+#endif /* ENABLE_CM0P_SENSING && ENABLE_CM4 */
+
+/* [] END OF FILE */
@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name: sensor_ipc.h
+*
+* Description: This file contains the declarations of the IPC pipe that passes
+*              the readings from CM0+ to CM4 when the sensing runs on CM0+.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SENSOR_IPC_H_
+#define SENSOR_IPC_H_
+
+#include "cy_pdl.h"
+#include "cy_ipc_config.h"
+#include "app_config.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Client of the system IPC pipe used by this application. Client IDs below
+ * this one are left to the PDL and middleware. */
+#define SENSOR_IPC_CLIENT_ID                (3UL)
+
+/* Message codes carried in the user code field of the message */
+#define SENSOR_IPC_CODE_READING             (1UL)
+#define SENSOR_IPC_CODE_SUBSCRIBE           (2UL)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Message sent over the pipe. The first word holds the client ID, the user
+ * code and the release mask as required by the PDL pipe. */
+typedef struct
+{
+    uint32 header;
+
+    /* Reading; valid with SENSOR_IPC_CODE_READING */
+    telemetry_reading_t reading;
+
+    /* Minimum interval between two readings in milliseconds, 0 to stop the
+     * readings; valid with SENSOR_IPC_CODE_SUBSCRIBE */
+    uint32 period_ms;
+} sensor_ipc_msg_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to register the client callback on the endpoint of this core */
+void sensor_ipc_init(void);
+
+/* Function for CM4 to request readings from CM0+ */
+bool sensor_ipc_subscribe(uint32 period_ms);
+
+/* Function for CM0+ to pass a reading to CM4 if CM4 requested one */
+bool sensor_ipc_publish(const telemetry_reading_t *reading);
+
+/* Function for CM4 to get the latest reading received */
+bool sensor_ipc_receive(telemetry_reading_t *reading);
+
+#endif /* SENSOR_IPC_H_ */
+
+/* [] END OF FILE */
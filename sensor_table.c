@@ -0,0 +1,374 @@
+/******************************************************************************
+* File Name: sensor_table.c
+*
+* Description: This file contains the sensor descriptor table of the board and
+*              the conversion of the filtered SAR counts of each sensor. The main
+*              loop iterates the table, so products with other sensor
+*              populations only change the table.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "sensor_table.h"
+
+#if ENABLE_CALIBRATION
+#include "calibration.h"
+#endif
+
+#if ENABLE_THERMISTOR_LUT
+#include "thermistor_lut.h"
+#else
+#include "math.h"
+#endif
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Reference resistor in series with the thermistor is of 10kohm */
+#define R_REFERENCE                         (float)(10000)
+
+/* Beta constant of NCP18XH103F03RB thermistor is 3380 Kelvin. See the thermistor
+   data sheet for more details. */
+#define B_CONSTANT                          (float)(3380)
+
+/* Resistance of the thermistor is 10K at 25 degrees C (from the data sheet)
+   Therefore R0 = 10000 Ohm, and T0 = 298.15 Kelvin, which gives
+   R_INFINITY = R0 e^(-B_CONSTANT / T0) = 0.1192855 */
+#define R_INFINITY                          (float)(0.1192855)
+
+/* Zero Kelvin in degree C */
+#define ABSOLUTE_ZERO                       (float)(-273.15)
+
+/* Conversion function of each sensor type */
+#define SENSOR_CONVERT_REFERENCE            (NULL)
+#define SENSOR_CONVERT_THERMISTOR           (sensor_convert_thermistor)
+#define SENSOR_CONVERT_THERMISTOR_RATIOMETRIC (sensor_convert_thermistor_ratiometric)
+#define SENSOR_CONVERT_ALS                  (sensor_convert_als)
+
+/* Entry of the sensor table generated from an entry of SENSOR_CONFIG */
+#define SENSOR_TABLE_ENTRY(name, channel_, ref_channel_, type_, engine_, length_, coefficient_, shift_) \
+    { \
+        .channel = (channel_), \
+        .ref_channel = (ref_channel_), \
+        .type = SENSOR_TYPE_##type_, \
+        .convert = SENSOR_CONVERT_##type_, \
+        .filter = \
+        { \
+            .engine = FILTER_ENGINE_##engine_, \
+            .length = (length_), \
+            .coefficient = (coefficient_), \
+            .shift = (shift_), \
+            .initial_value = 0 \
+        } \
+    },
+
+#if ENABLE_STATIC_PIPELINE
+/* Conversion of an entry of SENSOR_CONFIG as a direct call, or 0 for a sensor
+ * without an output */
+#define SENSOR_STATIC_CONVERT_REFERENCE(index, filtered_data) (0)
+#define SENSOR_STATIC_CONVERT_THERMISTOR(index, filtered_data) \
+    sensor_convert_thermistor(&sensor_table[index], (filtered_data))
+#define SENSOR_STATIC_CONVERT_THERMISTOR_RATIOMETRIC(index, filtered_data) \
+    sensor_convert_thermistor_ratiometric(&sensor_table[index], (filtered_data))
+#define SENSOR_STATIC_CONVERT_ALS(index, filtered_data) \
+    sensor_convert_als(&sensor_table[index], (filtered_data))
+
+#define SENSOR_STATIC_CONVERT_ENTRY(name, channel, ref_channel, type, ...) \
+    values[SENSOR_INDEX_##name] = SENSOR_STATIC_CONVERT_##type(SENSOR_INDEX_##name, filtered_data);
+#endif
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Sensor descriptor table, generated from SENSOR_CONFIG in sensor_config.h.
+ * SAR channels without an entry pass the first sample through and hold it. */
+const sensor_desc_t sensor_table[SENSOR_COUNT] =
+{
+    SENSOR_CONFIG(SENSOR_TABLE_ENTRY)
+};
+
+
+/*******************************************************************************
+* Function Name: sensor_table_init
+********************************************************************************
+* Summary:
+* This function checks that every entry of the sensor table refers to a
+* channel scanned by the SAR sequencer and loads the filter of each channel.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sensor_table_init(void)
+{
+    uint8 sensor;
+
+    filter_bank_init();
+
+    for(sensor = 0; sensor < SENSOR_COUNT; sensor++)
+    {
+        if(((SAR_SCAN_CHANNEL_MASK & (1UL << sensor_table[sensor].channel)) == 0UL) ||
+           ((SAR_SCAN_CHANNEL_MASK & (1UL << sensor_table[sensor].ref_channel)) == 0UL))
+        {
+            CY_ASSERT(0);
+        }
+
+        filter_bank_configure(sensor_table[sensor].channel, &sensor_table[sensor].filter);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sensor_table_convert
+********************************************************************************
+* Summary:
+* This function converts the filtered counts of every sensor of the table.
+* The cost is one indirect call per sensor with an output. With
+* ENABLE_STATIC_PIPELINE, the loop is generated from SENSOR_CONFIG as one
+* direct call per sensor with an output, which the compiler can inline, and
+* the sensors without an output are set to 0 without a test.
+*
+* Parameters:
+*  filtered_data: filter output of each SAR channel
+*  values: array of SENSOR_COUNT entries to receive the outputs; entries of
+*          sensors without an output are set to 0
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sensor_table_convert(const int32 *filtered_data, int32 *values)
+{
+#if ENABLE_STATIC_PIPELINE
+    SENSOR_CONFIG(SENSOR_STATIC_CONVERT_ENTRY)
+#else
+    const sensor_desc_t *sensor;
+
+    for(sensor = sensor_table; sensor < &sensor_table[SENSOR_COUNT]; sensor++)
+    {
+        *values++ = (sensor->convert != NULL) ? sensor->convert(sensor, filtered_data) : 0;
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: sensor_convert_thermistor
+********************************************************************************
+* Summary:
+* This function converts the filtered counts of a thermistor and of its
+* reference resistor into temperature.
+*
+* Parameters:
+*  sensor: descriptor of the thermistor
+*  filtered_data: filter output of each SAR channel
+*
+* Return:
+*  temperature in 0.01 degree celsius
+*
+*******************************************************************************/
+int32 sensor_convert_thermistor(const sensor_desc_t *sensor, const int32 *filtered_data)
+{
+#if ENABLE_THERMISTOR_LUT
+    return(get_temperature(filtered_data[sensor->channel], filtered_data[sensor->ref_channel]));
+#else
+    return((int32)(get_temperature(filtered_data[sensor->channel], filtered_data[sensor->ref_channel]) * 100.0f));
+#endif
+}
+
+/*******************************************************************************
+* Function Name: sensor_convert_thermistor_ratiometric
+********************************************************************************
+* Summary:
+* This function converts the filtered counts of a thermistor measured against
+* the SAR reference into temperature. The divider of the reference resistor
+* and the thermistor is excited with the SAR reference voltage (VDDA), so the
+* reference resistor holds the rest of the full scale and
+* Rthermistor / Rreference = count / (SENSOR_RATIOMETRIC_FULL_SCALE - count).
+* Any difference between the excitation and VDDA, such as the drop across the
+* pins, is an error of this mode that the two-channel measurement cancels.
+*
+* Parameters:
+*  sensor: descriptor of the thermistor
+*  filtered_data: filter output of each SAR channel
+*
+* Return:
+*  temperature in 0.01 degree celsius
+*
+*******************************************************************************/
+int32 sensor_convert_thermistor_ratiometric(const sensor_desc_t *sensor, const int32 *filtered_data)
+{
+    int32 therm_count = filtered_data[sensor->channel];
+
+    /* Keep the reference share positive at full scale */
+    if(therm_count >= SENSOR_RATIOMETRIC_FULL_SCALE)
+        therm_count = SENSOR_RATIOMETRIC_FULL_SCALE - 1;
+
+#if ENABLE_THERMISTOR_LUT
+    return(get_temperature(therm_count, SENSOR_RATIOMETRIC_FULL_SCALE - therm_count));
+#else
+    return((int32)(get_temperature(therm_count, SENSOR_RATIOMETRIC_FULL_SCALE - therm_count) * 100.0f));
+#endif
+}
+
+/*******************************************************************************
+* Function Name: sensor_convert_als
+********************************************************************************
+* Summary:
+* This function converts the filtered counts of an ambient light sensor into
+* light intensity.
+*
+* Parameters:
+*  sensor: descriptor of the ambient light sensor
+*  filtered_data: filter output of each SAR channel
+*
+* Return:
+*  ambient light intensity in percentage (0 - 100)
+*
+*******************************************************************************/
+int32 sensor_convert_als(const sensor_desc_t *sensor, const int32 *filtered_data)
+{
+    return((int32)get_light_intensity(filtered_data[sensor->channel]));
+}
+
+/*******************************************************************************
+* Function Name: get_temperature
+********************************************************************************
+* Summary:
+* This function calculates the temperature in degree celsius.
+*
+* Parameters:
+*  ADC results for thermistor and reference resistor voltages
+*
+* Return:
+*  temperature in 0.01 degree celsius (int32) when ENABLE_THERMISTOR_LUT is set,
+*  otherwise temperature in degree celsius (float)
+*
+*******************************************************************************/
+#if ENABLE_THERMISTOR_LUT
+int32 get_temperature(int32 therm_count, int32 ref_count)
+{
+    /* Look up the temperature in 0.01 deg C, with the table of the device
+     * when it is calibrated */
+#if ENABLE_CALIBRATION
+    return(calibration_get_temperature(get_thermistor_ratio(therm_count, ref_count)));
+#else
+    return(thermistor_lut_get_temperature(get_thermistor_ratio(therm_count, ref_count)));
+#endif
+}
+
+/*******************************************************************************
+* Function Name: get_thermistor_ratio
+********************************************************************************
+* Summary:
+* This function calculates the thermistor to reference resistance ratio.
+*
+* Parameters:
+*  ADC results for thermistor and reference resistor voltages
+*
+* Return:
+*  ratio in Q16 format; UINT32_MAX, beyond the lowest temperature of the
+*  table, if the reference result is not positive
+*
+*******************************************************************************/
+uint32 get_thermistor_ratio(int32 therm_count, int32 ref_count)
+{
+    if(therm_count < 0)
+        therm_count = 0;
+
+    /* Avoid division by zero */
+    if(ref_count <= 0)
+        return(UINT32_MAX);
+
+    return(((uint32)therm_count << THERMISTOR_LUT_RATIO_SHIFT) / (uint32)ref_count);
+}
+#else
+float get_temperature(int32 therm_count, int32 ref_count)
+{
+    float temperature;
+    float rThermistor;
+
+    /* Calculate the thermistor resistance */
+    rThermistor = therm_count * R_REFERENCE / ref_count;
+
+    /* Calculate the temperature in deg C */
+    temperature = (B_CONSTANT/(logf(rThermistor/R_INFINITY))) + ABSOLUTE_ZERO;
+
+    return(temperature);
+}
+#endif
+
+/*******************************************************************************
+* Function Name: get_light_intensity
+********************************************************************************
+* Summary:
+* This function calculates the ambient light intensity in terms of percentage.
+*
+* Parameters:
+*  ADC measurement result of the photo-transistor
+*
+* Return:
+*  ambient light intensity in percentage (uint8: 0 - 100)
+*
+*******************************************************************************/
+uint8 get_light_intensity(int32 adc_count)
+{
+#if ENABLE_CALIBRATION
+    /* Gain and offset of the device */
+    return(calibration_get_light_intensity(adc_count));
+#else
+    int16 als_level;
+    
+    if(adc_count < 0)
+        adc_count = 0;
+
+    /* Calculate the ambient light intensity in terms of percentage */
+    /* Adjust the shift parameter for the required sensitivity */
+    als_level = ((adc_count * 100)>>10) - ALS_OFFSET;
+
+    /* Limit the values between 0 and 100 */
+    if(als_level > 100)
+        als_level = 100;
+
+    if(als_level < 0)
+        als_level = 0;
+
+    return((uint8)als_level);
+#endif
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,147 @@
+/******************************************************************************
+* File Name: sensor_table.h
+*
+* Description: This file contains the declarations of the sensor descriptor
+*              table. Each entry maps a SAR channel to a sensor type, its filter
+*              parameters and the function converting the filtered counts.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SENSOR_TABLE_H_
+#define SENSOR_TABLE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+#include "filter_bank.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of entries of the sensor table, one per entry of SENSOR_CONFIG */
+#define SENSOR_COUNT                        (0 SENSOR_CONFIG(SENSOR_CONFIG_COUNT_ENTRY))
+
+/* Entries of the sensor table reported in the telemetry and used for the LED
+ * control */
+#define SENSOR_TEMPERATURE_INDEX            (SENSOR_INDEX_TEMPERATURE)
+#define SENSOR_LIGHT_INDEX                  (SENSOR_INDEX_LIGHT)
+
+/* Differential result for an input equal to the SAR reference, that is, the
+ * voltage across the whole thermistor divider in the ratiometric mode */
+#define SENSOR_RATIOMETRIC_FULL_SCALE       (2048)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Index of each entry of the sensor table, SENSOR_INDEX_<name> */
+#define SENSOR_CONFIG_INDEX_ENTRY(name, ...) SENSOR_INDEX_##name,
+
+typedef enum
+{
+    SENSOR_CONFIG(SENSOR_CONFIG_INDEX_ENTRY)
+} sensor_index_t;
+
+/* Type of a sensor */
+typedef enum
+{
+    SENSOR_TYPE_REFERENCE,          /* Reference resistor; no output of its own */
+    SENSOR_TYPE_THERMISTOR,         /* Thermistor against a reference resistor channel */
+    SENSOR_TYPE_THERMISTOR_RATIOMETRIC, /* Thermistor against the SAR reference */
+    SENSOR_TYPE_ALS                 /* Ambient light sensor */
+} sensor_type_t;
+
+typedef struct sensor_desc sensor_desc_t;
+
+/* Function converting the filtered counts of a sensor into its output: 0.01
+ * deg C for a thermistor, percentage for an ALS */
+typedef int32 (*sensor_convert_t)(const sensor_desc_t *sensor, const int32 *filtered_data);
+
+/* Descriptor of a sensor */
+struct sensor_desc
+{
+    /* SAR channel of the sensor */
+    uint8 channel;
+
+    /* SAR channel the sensor is measured against, if any */
+    uint8 ref_channel;
+
+    /* Type of the sensor */
+    sensor_type_t type;
+
+    /* Conversion of the filtered counts; NULL if the sensor has no output */
+    sensor_convert_t convert;
+
+    /* IIR filter of the channel */
+    filter_bank_desc_t filter;
+};
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Sensor descriptor table */
+extern const sensor_desc_t sensor_table[SENSOR_COUNT];
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to check the table and set up the filter of every sensor */
+void sensor_table_init(void);
+
+/* Function to convert the filtered counts of every sensor */
+void sensor_table_convert(const int32 *filtered_data, int32 *values);
+
+/* Conversion functions of the sensor types */
+int32 sensor_convert_thermistor(const sensor_desc_t *sensor, const int32 *filtered_data);
+int32 sensor_convert_thermistor_ratiometric(const sensor_desc_t *sensor, const int32 *filtered_data);
+int32 sensor_convert_als(const sensor_desc_t *sensor, const int32 *filtered_data);
+
+/* Function to convert the measured voltage in the thermistor circuit into
+ * temperature */
+#if ENABLE_THERMISTOR_LUT
+int32 get_temperature(int32 therm_count, int32 ref_count);
+
+/* Function to calculate the thermistor to reference resistance ratio (Q16) */
+uint32 get_thermistor_ratio(int32 therm_count, int32 ref_count);
+#else
+float get_temperature(int32 therm_count, int32 ref_count);
+#endif
+
+/* Function to convert the measured voltage in the ALS circuit into percentage */
+uint8 get_light_intensity(int32 adc_count);
+
+#endif /* SENSOR_TABLE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,793 @@
+/******************************************************************************
+* File Name: telemetry.c
+*
+* Description: This file contains the non-blocking UART telemetry. The debug UART
+*              of retarget-io transmits with DMA while the CPU sleeps, and a SysPm
+*              callback keeps the device out of deep sleep till the transfer is
+*              complete.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "telemetry.h"
+#include "cy_retarget_io.h"
+#include "power_manager.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void telemetry_uart_event_handler(void *callback_arg, cyhal_uart_event_t event);
+
+static bool telemetry_is_idle(void);
+
+static char * telemetry_put_uint(char *buffer, uint32 value);
+
+static char * telemetry_put_int(char *buffer, int32 value);
+
+static char * telemetry_put_string(char *buffer, const char *string, uint16 max_length);
+
+#if ENABLE_RTC_TIMESTAMP
+static char * telemetry_put_digits(char *buffer, uint32 value, uint8 count);
+
+static char * telemetry_put_time(char *buffer, uint32 time_of_day_ms);
+#endif
+
+static uint8 * telemetry_put_le(uint8 *buffer, uint32 value, uint8 size);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Transmit buffer; the DMA reads from it till the transfer is done */
+static uint8 telemetry_tx_buffer[TELEMETRY_BUFFER_SIZE];
+
+/* This flag is set while an asynchronous transfer is in progress */
+static volatile bool telemetry_tx_busy = false;
+
+/* Sequence number of the next binary frame */
+static uint16 telemetry_sequence = 0;
+
+/* Deep sleep client: deep sleep is refused while a transfer is in progress,
+ * so that the CPU waits in CPU Sleep mode for the transmit done interrupt
+ * instead of polling the UART */
+static const power_manager_client_t telemetry_power_client =
+{
+    .is_ready = telemetry_is_idle,
+    .before_sleep = NULL,
+    .after_wake = NULL
+};
+
+
+/*******************************************************************************
+* Function Name: telemetry_init
+********************************************************************************
+* Summary:
+* This function switches the debug UART to DMA based asynchronous transfers,
+* enables the transmit done event and registers the deep sleep client. It must
+* be called after cy_retarget_io_init.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void telemetry_init(void)
+{
+    cy_rslt_t result;
+
+    result = cyhal_uart_set_async_mode(&cy_retarget_io_uart_obj, CYHAL_ASYNC_DMA, CYHAL_DMA_PRIORITY_DEFAULT);
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    cyhal_uart_register_callback(&cy_retarget_io_uart_obj, telemetry_uart_event_handler, NULL);
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_TX_DONE, CYHAL_ISR_PRIORITY_DEFAULT, true);
+
+    power_manager_register(&telemetry_power_client);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_format
+********************************************************************************
+* Summary:
+* This function formats a reading in the format selected by TELEMETRY_FORMAT.
+* With ENABLE_RTC_TIMESTAMP, ASCII lines start with the wall-clock time of the
+* reading, "hh:mm:ss.mmm  ".
+*
+* Parameters:
+*  buffer: buffer of at least TELEMETRY_BUFFER_SIZE bytes
+*  reading: reading to be formatted
+*
+* Return:
+*  Length of the formatted reading in bytes
+*
+*******************************************************************************/
+uint16 telemetry_format(void *buffer, const telemetry_reading_t *reading)
+{
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+    return(telemetry_format_frame((uint8 *)buffer, reading));
+#else
+    char *line = (char *)buffer;
+
+#if ENABLE_RTC_TIMESTAMP
+    line = telemetry_put_time(line, reading->time_of_day_ms);
+#endif
+
+    return((uint16)(line - (char *)buffer) +
+           telemetry_format_reading(line, reading->temperature, reading->light_intensity));
+#endif
+}
+
+/*******************************************************************************
+* Function Name: telemetry_format_reading
+********************************************************************************
+* Summary:
+* This function formats a reading as
+* "Temperature: 25.0C    Ambient Light: 50%\r\n" using integer arithmetic only.
+* Temperature is rounded to 0.1 deg C.
+*
+* Parameters:
+*  buffer: buffer of at least TELEMETRY_BUFFER_SIZE characters; the line is
+*          terminated with a NUL character
+*  temperature: temperature in 0.01 deg C
+*  light_intensity: ambient light intensity in percentage
+*
+* Return:
+*  Length of the line in characters
+*
+*******************************************************************************/
+uint16 telemetry_format_reading(char *buffer, int32 temperature, uint8 light_intensity)
+{
+    static const char temperature_label[] = "Temperature: ";
+    static const char light_label[] = "C    Ambient Light: ";
+    static const char line_end[] = "%\r\n";
+    char *p = buffer;
+    uint32 tenths;
+    uint8 i;
+
+    for(i = 0; i < (sizeof(temperature_label) - 1); i++)
+        *p++ = temperature_label[i];
+
+    if(temperature < 0)
+    {
+        *p++ = '-';
+        temperature = -temperature;
+    }
+
+    /* Round to 0.1 deg C */
+    tenths = ((uint32)temperature + 5UL) / 10UL;
+    p = telemetry_put_uint(p, tenths / 10UL);
+    *p++ = '.';
+    *p++ = (char)('0' + (tenths % 10UL));
+
+    for(i = 0; i < (sizeof(light_label) - 1); i++)
+        *p++ = light_label[i];
+
+    p = telemetry_put_uint(p, light_intensity);
+
+    for(i = 0; i < (sizeof(line_end) - 1); i++)
+        *p++ = line_end[i];
+
+    /* Terminate the string; the terminator is not counted in the length */
+    *p = '\0';
+
+    return((uint16)(p - buffer));
+}
+
+/*******************************************************************************
+* Function Name: telemetry_format_frame
+********************************************************************************
+* Summary:
+* This function formats a reading as a binary frame:
+*
+*  Offset  Size  Field
+*  0       1     Sync byte, 0xA5
+*  1       2     Sequence number, incremented per frame
+*  3       4     Timestamp in milliseconds
+*  7       2     Temperature in 0.01 deg C, signed
+*  9       1     Ambient light intensity in percentage
+*  10      1     Flags (TELEMETRY_FLAG_x)
+*  11      2     CRC-16/CCITT-FALSE of bytes 0 to 10
+*
+* Multi-byte fields are little-endian. Temperature is limited to the int16
+* range.
+*
+* Parameters:
+*  buffer: buffer of at least TELEMETRY_FRAME_SIZE bytes
+*  reading: reading to be formatted
+*
+* Return:
+*  Length of the frame in bytes
+*
+*******************************************************************************/
+uint16 telemetry_format_frame(uint8 *buffer, const telemetry_reading_t *reading)
+{
+    uint8 *p = buffer;
+    int32 temperature = reading->temperature;
+
+    if(temperature > INT16_MAX)
+        temperature = INT16_MAX;
+
+    if(temperature < INT16_MIN)
+        temperature = INT16_MIN;
+
+    *p++ = TELEMETRY_FRAME_SYNC;
+    p = telemetry_put_le(p, telemetry_sequence++, 2);
+    p = telemetry_put_le(p, reading->timestamp_ms, 4);
+    p = telemetry_put_le(p, (uint32)(uint16)(int16)temperature, 2);
+    *p++ = reading->light_intensity;
+    *p++ = reading->flags;
+    p = telemetry_put_le(p, telemetry_crc16(buffer, (uint16)(p - buffer)), 2);
+
+    return((uint16)(p - buffer));
+}
+
+/*******************************************************************************
+* Function Name: telemetry_format_event
+********************************************************************************
+* Summary:
+* This function formats an alarm event in the format selected by
+* TELEMETRY_FORMAT. The ASCII line is
+* "Alarm 0 Temperature rising: 2534 (153/min)\r\n" in the integer units of
+* the sensor output, preceded by the time of day with ENABLE_RTC_TIMESTAMP.
+* The binary frame is:
+*
+*  Offset  Size  Field
+*  0       1     Sync byte, 0xA7
+*  1       2     Sequence number, shared with the reading frames
+*  3       4     Timestamp in milliseconds
+*  7       1     Rule index
+*  8       4     Sensor output, signed
+*  12      4     Slope of the sensor output per minute, signed
+*  16      2     CRC-16/CCITT-FALSE of bytes 0 to 15
+*
+* Parameters:
+*  buffer: buffer of at least TELEMETRY_BUFFER_SIZE bytes
+*  event: event to be formatted
+*
+* Return:
+*  Length of the formatted event in bytes
+*
+*******************************************************************************/
+uint16 telemetry_format_event(void *buffer, const telemetry_event_t *event)
+{
+#if (TELEMETRY_FORMAT == TELEMETRY_FORMAT_BINARY)
+    uint8 *p = (uint8 *)buffer;
+
+    *p++ = TELEMETRY_EVENT_SYNC;
+    p = telemetry_put_le(p, telemetry_sequence++, 2);
+    p = telemetry_put_le(p, event->timestamp_ms, 4);
+    *p++ = event->rule;
+    p = telemetry_put_le(p, (uint32)event->value, 4);
+    p = telemetry_put_le(p, (uint32)event->slope, 4);
+    p = telemetry_put_le(p, telemetry_crc16((uint8 *)buffer, (uint16)(p - (uint8 *)buffer)), 2);
+
+    return((uint16)(p - (uint8 *)buffer));
+#else
+    char *p = (char *)buffer;
+
+#if ENABLE_RTC_TIMESTAMP
+    p = telemetry_put_time(p, event->time_of_day_ms);
+#endif
+
+    p = telemetry_put_string(p, "Alarm ", 6U);
+    p = telemetry_put_uint(p, event->rule);
+    *p++ = ' ';
+    p = telemetry_put_string(p, event->name, TELEMETRY_EVENT_NAME_MAX);
+    *p++ = ':';
+    *p++ = ' ';
+    p = telemetry_put_int(p, event->value);
+    *p++ = ' ';
+    *p++ = '(';
+    p = telemetry_put_int(p, event->slope);
+    p = telemetry_put_string(p, "/min)\r\n", 7U);
+
+    /* Terminate the string; the terminator is not counted in the length */
+    *p = '\0';
+
+    return((uint16)(p - (char *)buffer));
+#endif
+}
+
+/*******************************************************************************
+* Function Name: telemetry_get_sequence
+********************************************************************************
+* Summary:
+* This function returns the sequence number of the next binary frame or
+* event.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Sequence number
+*
+*******************************************************************************/
+uint16 telemetry_get_sequence(void)
+{
+    return(telemetry_sequence);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_set_sequence
+********************************************************************************
+* Summary:
+* This function sets the sequence number of the next binary frame or event,
+* so that the numbers continue across a restart.
+*
+* Parameters:
+*  sequence: sequence number of the next frame
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void telemetry_set_sequence(uint16 sequence)
+{
+    telemetry_sequence = sequence;
+}
+
+/*******************************************************************************
+* Function Name: telemetry_crc16
+********************************************************************************
+* Summary:
+* This function calculates the CRC-16/CCITT-FALSE (polynomial 0x1021, initial
+* value 0xFFFF, no reflection, no final XOR) of a block of data.
+*
+* Parameters:
+*  data: data to be checked
+*  length: number of bytes
+*
+* Return:
+*  CRC value
+*
+*******************************************************************************/
+uint16 telemetry_crc16(const uint8 *data, uint16 length)
+{
+    return(telemetry_crc16_update(TELEMETRY_CRC_INIT, data, length));
+}
+
+/*******************************************************************************
+* Function Name: telemetry_crc16_update
+********************************************************************************
+* Summary:
+* This function continues a CRC-16/CCITT-FALSE over a further block of data,
+* for data that is not contiguous.
+*
+* Parameters:
+*  crc: CRC value of the preceding data
+*  data: data to be checked
+*  length: number of bytes
+*
+* Return:
+*  CRC value
+*
+*******************************************************************************/
+uint16 telemetry_crc16_update(uint16 crc, const uint8 *data, uint16 length)
+{
+    uint8 bit;
+
+    while(length-- > 0U)
+    {
+        crc ^= (uint16)((uint16)*data++ << 8);
+
+        for(bit = 0; bit < 8U; bit++)
+            crc = ((crc & 0x8000U) != 0U) ? (uint16)((crc << 1) ^ TELEMETRY_CRC_POLYNOMIAL) : (uint16)(crc << 1);
+    }
+
+    return(crc);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_write
+********************************************************************************
+* Summary:
+* This function copies the data to the transmit buffer and starts the
+* transfer. The data is dropped if the previous transfer is not complete.
+*
+* Parameters:
+*  data: data to be sent
+*  length: number of bytes, up to TELEMETRY_BUFFER_SIZE
+*
+* Return:
+*  true if the transfer is started
+*
+*******************************************************************************/
+bool telemetry_write(const void *data, uint16 length)
+{
+    if(telemetry_is_busy() || (length > TELEMETRY_BUFFER_SIZE) || (length == 0))
+        return(false);
+
+    memcpy(telemetry_tx_buffer, data, length);
+
+    return(telemetry_write_buffer(telemetry_tx_buffer, length));
+}
+
+/*******************************************************************************
+* Function Name: telemetry_write_buffer
+********************************************************************************
+* Summary:
+* This function starts the transfer of the data directly from the caller's
+* buffer, which must not be modified till telemetry_is_busy returns false. With
+* ENABLE_ASYNC_TELEMETRY set to 0, the data is sent before this function
+* returns.
+*
+* Parameters:
+*  data: data to be sent
+*  length: number of bytes
+*
+* Return:
+*  true if the transfer is started
+*
+*******************************************************************************/
+bool telemetry_write_buffer(const void *data, uint16 length)
+{
+    cy_rslt_t result;
+
+    if(telemetry_is_busy() || (length == 0))
+        return(false);
+
+#if ENABLE_ASYNC_TELEMETRY
+    telemetry_tx_busy = true;
+    result = cyhal_uart_write_async(&cy_retarget_io_uart_obj, (void *)data, length);
+#else
+    {
+        size_t tx_length = length;
+        result = cyhal_uart_write(&cy_retarget_io_uart_obj, (void *)data, &tx_length);
+    }
+#endif
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        telemetry_tx_busy = false;
+        return(false);
+    }
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_is_busy
+********************************************************************************
+* Summary:
+* This function checks whether the asynchronous transfer is in progress or the
+* UART is still shifting out the last bytes.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true while the transfer is in progress
+*
+*******************************************************************************/
+bool telemetry_is_busy(void)
+{
+    return(telemetry_tx_busy || cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj));
+}
+
+/*******************************************************************************
+* Function Name: telemetry_wait_idle
+********************************************************************************
+* Summary:
+* This function waits till the transfer in progress is done. The CPU waits in
+* CPU Sleep mode for the TX done interrupt of the asynchronous transfer; the
+* busy flag is checked with the interrupts masked, so that an interrupt that
+* arrives just before the sleep still wakes the CPU. Only the last bytes in the
+* UART FIFO are then waited for by polling, which is bounded by the FIFO depth.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void telemetry_wait_idle(void)
+{
+    uint32 interrupt_state;
+
+    for(;;)
+    {
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+        if(!telemetry_tx_busy)
+        {
+            Cy_SysLib_ExitCriticalSection(interrupt_state);
+            break;
+        }
+
+        (void)Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+    }
+
+    while(cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj));
+}
+
+/*******************************************************************************
+* Function Name: telemetry_read_decimal
+********************************************************************************
+* Summary:
+* This function reads an unsigned decimal number terminated by a carriage
+* return or a line feed from the host, such as the argument of a host command.
+*
+* Parameters:
+*  value: number received
+*  char_timeout_ms: time allowed for each character
+*
+* Return:
+*  true if a number of 1 to 10 digits that fits in 32 bits was received
+*
+*******************************************************************************/
+bool telemetry_read_decimal(uint32 *value, uint32 char_timeout_ms)
+{
+    uint64_t number = 0;
+    uint8 digits = 0;
+    uint8 character;
+
+    while(cyhal_uart_getc(&cy_retarget_io_uart_obj, &character, char_timeout_ms) == CY_RSLT_SUCCESS)
+    {
+        if((character == '\r') || (character == '\n'))
+        {
+            if((digits == 0U) || (number > UINT32_MAX))
+                return(false);
+
+            *value = (uint32)number;
+            return(true);
+        }
+
+        if((character < '0') || (character > '9') || (digits >= 10U))
+            return(false);
+
+        number = (number * 10U) + (uint32)(character - '0');
+        digits++;
+    }
+
+    return(false);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_uart_event_handler
+********************************************************************************
+* Summary:
+* This function is the handler for the UART events. It clears the busy flag when
+* the asynchronous transfer is done.
+*
+* Parameters:
+*  callback_arg: not used
+*  event: UART event
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void telemetry_uart_event_handler(void *callback_arg, cyhal_uart_event_t event)
+{
+    (void)callback_arg;
+
+    if((event & CYHAL_UART_IRQ_TX_DONE) != 0U)
+        telemetry_tx_busy = false;
+}
+
+/*******************************************************************************
+* Function Name: telemetry_is_idle
+********************************************************************************
+* Summary:
+* This function is the deep sleep check of the telemetry.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if no transfer is in progress
+*
+*******************************************************************************/
+static bool telemetry_is_idle(void)
+{
+    return(!telemetry_is_busy());
+}
+
+/*******************************************************************************
+* Function Name: telemetry_put_uint
+********************************************************************************
+* Summary:
+* This function writes the decimal digits of an unsigned value.
+*
+* Parameters:
+*  buffer: position to write the digits to
+*  value: value to be written
+*
+* Return:
+*  Position after the last digit
+*
+*******************************************************************************/
+static char * telemetry_put_uint(char *buffer, uint32 value)
+{
+    char digits[10];
+    uint8 count = 0;
+
+    do
+    {
+        digits[count++] = (char)('0' + (value % 10UL));
+        value /= 10UL;
+    } while(value != 0UL);
+
+    while(count > 0)
+        *buffer++ = digits[--count];
+
+    return(buffer);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_put_int
+********************************************************************************
+* Summary:
+* This function writes a signed decimal number without leading zeros.
+*
+* Parameters:
+*  buffer: position to write the number to
+*  value: value to be written
+*
+* Return:
+*  Position after the last digit
+*
+*******************************************************************************/
+static char * telemetry_put_int(char *buffer, int32 value)
+{
+    if(value < 0)
+    {
+        *buffer++ = '-';
+
+        /* Negated in unsigned arithmetic so that INT32_MIN is handled */
+        return(telemetry_put_uint(buffer, 0UL - (uint32)value));
+    }
+
+    return(telemetry_put_uint(buffer, (uint32)value));
+}
+
+/*******************************************************************************
+* Function Name: telemetry_put_string
+********************************************************************************
+* Summary:
+* This function copies a string without its terminator.
+*
+* Parameters:
+*  buffer: position to write the string to
+*  string: string to be written
+*  max_length: number of characters after which the string is cut
+*
+* Return:
+*  Position after the last character
+*
+*******************************************************************************/
+static char * telemetry_put_string(char *buffer, const char *string, uint16 max_length)
+{
+    while((max_length-- > 0U) && (*string != '\0'))
+        *buffer++ = *string++;
+
+    return(buffer);
+}
+
+#if ENABLE_RTC_TIMESTAMP
+/*******************************************************************************
+* Function Name: telemetry_put_digits
+********************************************************************************
+* Summary:
+* This function writes the decimal digits of an unsigned value, padded with
+* leading zeros.
+*
+* Parameters:
+*  buffer: position to write the digits to
+*  value: value to be written; lower than 10^count
+*  count: number of digits
+*
+* Return:
+*  Position after the last digit
+*
+*******************************************************************************/
+static char * telemetry_put_digits(char *buffer, uint32 value, uint8 count)
+{
+    uint8 i;
+
+    for(i = count; i > 0; i--)
+    {
+        buffer[i - 1] = (char)('0' + (value % 10UL));
+        value /= 10UL;
+    }
+
+    return(buffer + count);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_put_time
+********************************************************************************
+* Summary:
+* This function writes a time of day as "hh:mm:ss.mmm  ".
+*
+* Parameters:
+*  buffer: position to write the time to
+*  time_of_day_ms: milliseconds since midnight
+*
+* Return:
+*  Position after the time
+*
+*******************************************************************************/
+static char * telemetry_put_time(char *buffer, uint32 time_of_day_ms)
+{
+    buffer = telemetry_put_digits(buffer, time_of_day_ms / 3600000UL, 2);
+    *buffer++ = ':';
+    buffer = telemetry_put_digits(buffer, (time_of_day_ms / 60000UL) % 60UL, 2);
+    *buffer++ = ':';
+    buffer = telemetry_put_digits(buffer, (time_of_day_ms / 1000UL) % 60UL, 2);
+    *buffer++ = '.';
+    buffer = telemetry_put_digits(buffer, time_of_day_ms % 1000UL, 3);
+    *buffer++ = ' ';
+    *buffer++ = ' ';
+
+    return(buffer);
+}
+#endif
+
+/*******************************************************************************
+* Function Name: telemetry_put_le
+********************************************************************************
+* Summary:
+* This function writes a value in little-endian byte order.
+*
+* Parameters:
+*  buffer: position to write the value to
+*  value: value to be written
+*  size: number of bytes
+*
+* Return:
+*  Position after the last byte
+*
+*******************************************************************************/
+static uint8 * telemetry_put_le(uint8 *buffer, uint32 value, uint8 size)
+{
+    while(size-- > 0U)
+    {
+        *buffer++ = (uint8)value;
+        value >>= 8;
+    }
+
+    return(buffer);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,174 @@
+/******************************************************************************
+* File Name: telemetry.h
+*
+* Description: This file contains the interface of the non-blocking UART telemetry.
+*              Readings are formatted with integer arithmetic and sent with an
+*              asynchronous DMA transfer.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "cy_pdl.h"
+#include "cyhal.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Size of the transmit buffer; longest ASCII line is an alarm event,
+ * "23:59:59.999  Alarm 7 <name>: -2147483648 (-2147483648/min)\r\n" with a
+ * name of up to TELEMETRY_EVENT_NAME_MAX characters */
+#define TELEMETRY_BUFFER_SIZE               (80)
+
+/* Output formats */
+#define TELEMETRY_FORMAT_ASCII              (0)
+#define TELEMETRY_FORMAT_BINARY             (1)
+
+/* Binary frame: sync, sequence (2), timestamp (4), temperature (2), ALS (1),
+ * flags (1), CRC (2). Multi-byte fields are little-endian. */
+#define TELEMETRY_FRAME_SYNC                (0xA5U)
+#define TELEMETRY_FRAME_SIZE                (13U)
+
+/* Binary alarm event: sync, sequence (2), timestamp (4), rule (1), value (4),
+ * slope (4), CRC (2). The sequence number is shared with the reading frames. */
+#define TELEMETRY_EVENT_SYNC                (0xA7U)
+#define TELEMETRY_EVENT_SIZE                (18U)
+
+/* Longest rule name printed in an ASCII alarm event */
+#define TELEMETRY_EVENT_NAME_MAX            (20U)
+
+/* CRC-16/CCITT-FALSE over the frame from the sync byte to the flags */
+#define TELEMETRY_CRC_POLYNOMIAL            (0x1021U)
+#define TELEMETRY_CRC_INIT                  (0xFFFFU)
+
+/* Bits of the flags field */
+#define TELEMETRY_FLAG_LED_ON               (0x01U)
+#define TELEMETRY_FLAG_SLOW_RATE            (0x02U)
+#define TELEMETRY_FLAG_SAMPLE_LOSS          (0x04U)
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Reading reported over UART */
+typedef struct
+{
+    /* Time since the start of sampling in milliseconds */
+    uint32 timestamp_ms;
+
+    /* Wall-clock time of the reading in milliseconds since midnight UTC */
+    uint32 time_of_day_ms;
+
+    /* Temperature in 0.01 deg C */
+    int32 temperature;
+
+    /* Ambient light intensity in percentage */
+    uint8 light_intensity;
+
+    /* Combination of TELEMETRY_FLAG_x */
+    uint8 flags;
+} telemetry_reading_t;
+
+/* Alarm event reported over UART */
+typedef struct
+{
+    /* Time since the start of sampling in milliseconds */
+    uint32 timestamp_ms;
+
+    /* Wall-clock time of the event in milliseconds since midnight UTC */
+    uint32 time_of_day_ms;
+
+    /* Index of the rule that fired */
+    uint8 rule;
+
+    /* Name of the rule; only used in the ASCII format */
+    const char *name;
+
+    /* Sensor output when the rule fired: 0.01 deg C or percentage */
+    int32 value;
+
+    /* Slope of the sensor output per minute when the rule fired */
+    int32 slope;
+} telemetry_event_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to set up the asynchronous transfer and the deep sleep client */
+void telemetry_init(void);
+
+/* Function to format a reading in the format selected by TELEMETRY_FORMAT */
+uint16 telemetry_format(void *buffer, const telemetry_reading_t *reading);
+
+/* Function to format a reading as an ASCII line */
+uint16 telemetry_format_reading(char *buffer, int32 temperature, uint8 light_intensity);
+
+/* Function to format a reading as a binary frame */
+uint16 telemetry_format_frame(uint8 *buffer, const telemetry_reading_t *reading);
+
+/* Function to format an alarm event in the format selected by TELEMETRY_FORMAT */
+uint16 telemetry_format_event(void *buffer, const telemetry_event_t *event);
+
+/* Functions to get and set the sequence number of the next binary frame */
+uint16 telemetry_get_sequence(void);
+void telemetry_set_sequence(uint16 sequence);
+
+/* Function to calculate the CRC of the binary frame */
+uint16 telemetry_crc16(const uint8 *data, uint16 length);
+
+/* Function to continue the CRC over a further block of data */
+uint16 telemetry_crc16_update(uint16 crc, const uint8 *data, uint16 length);
+
+/* Function to start the transfer of a block of data */
+bool telemetry_write(const void *data, uint16 length);
+
+/* Function to start the transfer of a block of data from the caller's buffer */
+bool telemetry_write_buffer(const void *data, uint16 length);
+
+/* Function to check whether a transfer is in progress */
+bool telemetry_is_busy(void);
+
+/* Function to wait in CPU Sleep mode till the transfer in progress is done */
+void telemetry_wait_idle(void);
+
+/* Function to read a decimal number sent by the host */
+bool telemetry_read_decimal(uint32 *value, uint32 char_timeout_ms);
+
+#endif /* TELEMETRY_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,121 @@
+/******************************************************************************
+* File Name: thermistor_lut.c
+*
+* Description: This file contains the float-free thermistor conversion. The
+*              temperature is looked up from the table generated by
+*              scripts/thermistor_lut_gen.py and interpolated between entries.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "thermistor_lut.h"
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Ratio of thermistor to reference resistance (Q16) at each temperature step.
+ * Entries are in decreasing order as the thermistor has a negative temperature
+ * coefficient. */
+static const uint32 thermistor_lut[THERMISTOR_LUT_ENTRIES] = THERMISTOR_LUT_TABLE;
+
+
+/*******************************************************************************
+* Function Name: thermistor_lut_get_temperature
+********************************************************************************
+* Summary:
+* This function converts a ratio with the table generated from the Beta model.
+* Worst case error against the Beta model is 0.05 deg C over -40 to 125 deg C.
+*
+* Parameters:
+*  ratio_q16: thermistor count / reference count in Q16 format
+*
+* Return:
+*  temperature in 0.01 deg C
+*
+*******************************************************************************/
+int32 thermistor_lut_get_temperature(uint32 ratio_q16)
+{
+    return(thermistor_lut_interpolate(thermistor_lut, ratio_q16));
+}
+
+/*******************************************************************************
+* Function Name: thermistor_lut_interpolate
+********************************************************************************
+* Summary:
+* This function finds the table entries around the given ratio with a binary
+* search and interpolates linearly between them. Temperatures outside the table
+* range are limited to the first and last entry.
+*
+* Parameters:
+*  table: THERMISTOR_LUT_ENTRIES ratios in decreasing order, one per
+*         THERMISTOR_LUT_T_STEP_CENTI from THERMISTOR_LUT_T_MIN_CENTI on
+*  ratio_q16: thermistor count / reference count in Q16 format
+*
+* Return:
+*  temperature in 0.01 deg C
+*
+*******************************************************************************/
+int32 thermistor_lut_interpolate(const uint32 *table, uint32 ratio_q16)
+{
+    uint32 low = 0;
+    uint32 high = THERMISTOR_LUT_ENTRIES - 1;
+    uint32 mid;
+
+    /* Limit the values to the table range */
+    if(ratio_q16 >= table[low])
+        return(THERMISTOR_LUT_T_MIN_CENTI);
+
+    if(ratio_q16 <= table[high])
+        return(THERMISTOR_LUT_T_MIN_CENTI + (int32)(high * THERMISTOR_LUT_T_STEP_CENTI));
+
+    /* Find low and high such that table[low] > ratio >= table[high] */
+    while((high - low) > 1)
+    {
+        mid = (low + high) >> 1;
+
+        if(table[mid] > ratio_q16)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    /* Interpolate between the two entries */
+    return(THERMISTOR_LUT_T_MIN_CENTI + (int32)(low * THERMISTOR_LUT_T_STEP_CENTI) +
+           (int32)((THERMISTOR_LUT_T_STEP_CENTI * (table[low] - ratio_q16)) /
+                   (table[low] - table[high])));
+}
+
+/* [] END OF FILE */
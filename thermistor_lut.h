@@ -0,0 +1,61 @@
+/******************************************************************************
+* File Name: thermistor_lut.h
+*
+* Description: This file contains the interface of the float-free thermistor
+*              conversion based on a lookup table with linear interpolation.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef THERMISTOR_LUT_H_
+#define THERMISTOR_LUT_H_
+
+#include "cy_pdl.h"
+#include "thermistor_lut_table.h"
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to convert the ratio of thermistor to reference resistor counts
+ * (Q16) into temperature in 0.01 deg C */
+int32 thermistor_lut_get_temperature(uint32 ratio_q16);
+
+/* Function to convert a ratio (Q16) into temperature with the given table */
+int32 thermistor_lut_interpolate(const uint32 *table, uint32 ratio_q16);
+
+#endif /* THERMISTOR_LUT_H_ */
+
+/* [] END OF FILE */
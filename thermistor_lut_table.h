@@ -0,0 +1,33 @@
+/* Generated by scripts/thermistor_lut_gen.py - do not edit. */
+
+#ifndef THERMISTOR_LUT_TABLE_H_
+#define THERMISTOR_LUT_TABLE_H_
+
+/* Temperature of the first entry and step between entries in 0.01 deg C */
+#define THERMISTOR_LUT_T_MIN_CENTI         (-4000)
+#define THERMISTOR_LUT_T_STEP_CENTI        (250)
+
+/* Number of entries in the table */
+#define THERMISTOR_LUT_ENTRIES             (67)
+
+/* Fractional bits of the ratio (thermistor count / reference count) */
+#define THERMISTOR_LUT_RATIO_SHIFT         (16)
+
+/* Ratio at each temperature step, from the Beta model: B = 3380 K, R0 = 10 kohm */
+#define THERMISTOR_LUT_TABLE                                              \
+{   \
+    1545540UL, 1325214UL, 1139972UL,  983697UL,  851422UL,  739103UL, \
+     643433UL,  561697UL,  491662UL,  431481UL,  379626UL,  334824UL, \
+     296015UL,  262311UL,  232970UL,  207364UL,  184967UL,  165331UL, \
+     148078UL,  132886UL,  119481UL,  107629UL,   97128UL,   87806UL, \
+      79516UL,   72129UL,   65536UL,   59640UL,   54360UL,   49621UL, \
+      45364UL,   41531UL,   38076UL,   34956UL,   32135UL,   29580UL, \
+      27264UL,   25160UL,   23247UL,   21506UL,   19918UL,   18468UL, \
+      17143UL,   15930UL,   14819UL,   13800UL,   12865UL,   12004UL, \
+      11212UL,   10483UL,    9810UL,    9189UL,    8615UL,    8084UL, \
+       7592UL,    7136UL,    6713UL,    6320UL,    5955UL,    5616UL, \
+       5300UL,    5005UL,    4730UL,    4474UL,    4234UL,    4011UL, \
+       3801UL  \
+}
+
+#endif /* THERMISTOR_LUT_TABLE_H_ */
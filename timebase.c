@@ -0,0 +1,431 @@
+/******************************************************************************
+* File Name: timebase.c
+*
+* Description: This file contains the time base of the readings. The time since
+*              the start of sampling is counted by a free-running low-power timer
+*              (MCWDT) clocked by LFCLK, so it does not depend on the FIFO level
+*              or the sample rate; the wall-clock time is that count plus an
+*              offset loaded from the RTC or set by the host.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include <time.h>
+#include "cyhal.h"
+#include "timebase.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Days from 0000-03-01 to 1970-01-01 in the proleptic Gregorian calendar */
+#define TIMEBASE_DAYS_TO_EPOCH              (719468L)
+
+/* Days in a 400-year era */
+#define TIMEBASE_DAYS_PER_ERA               (146097L)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+#if ENABLE_RTC_TIMESTAMP
+static uint32 timebase_tm_to_seconds(const struct tm *time);
+static void timebase_seconds_to_tm(uint32 seconds, struct tm *time);
+static void timebase_align_rtc(void);
+#endif
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+#if ENABLE_RTC_TIMESTAMP
+/* Free-running low-power timer and RTC */
+static cyhal_lptimer_t timebase_timer;
+static cyhal_rtc_t timebase_rtc;
+
+/* LFCLK frequency in Hz */
+static uint32 timebase_lfclk_hz;
+
+/* Timer count at the last read and LFCLK cycles since the start of sampling */
+static uint32 timebase_last_ticks;
+static uint64_t timebase_ticks;
+
+/* Set while the wall-clock time is taken from the start of the RTC second
+ * read at startup, till the next second tick of the RTC */
+static bool timebase_rtc_pending = false;
+static uint32 timebase_rtc_seconds;
+#else
+/* Sum of the wake-up periods since the start of sampling */
+static uint64_t timebase_uptime;
+#endif
+
+/* Wall-clock time at the start of sampling in milliseconds since 1970-01-01 */
+static uint64_t timebase_wall_offset_ms = 0;
+
+
+/*******************************************************************************
+* Function Name: timebase_init
+********************************************************************************
+* Summary:
+* This function starts the low-power timer and, if the RTC holds a valid time,
+* loads the wall-clock time from it. The RTC counts whole seconds, so the load
+* waits for the next second tick of the RTC; it takes up to one second.
+* Without the wait, the wall-clock time starts from the current second of the
+* RTC, up to one second late, and is aligned to the first second tick seen
+* by timebase_get_wall_ms.
+*
+* With TIMEBASE_USE_WCO, LFCLK is switched to the WCO first, which takes up to
+* TIMEBASE_WCO_TIMEOUT_US. This function must be called before the PASS timer
+* and the other low-power timers are started.
+*
+* Parameters:
+*  wait_for_rtc_tick: true to wait for the second tick of the RTC
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void timebase_init(bool wait_for_rtc_tick)
+{
+#if ENABLE_RTC_TIMESTAMP
+    struct tm time;
+    uint32 seconds;
+
+#if TIMEBASE_USE_WCO
+    /* The ILO stays the LFCLK source if the crystal does not start. LFCLK
+     * clocks the WDT, which must be unlocked to change the source. */
+    if(Cy_SysClk_WcoEnable(TIMEBASE_WCO_TIMEOUT_US) == CY_SYSCLK_SUCCESS)
+    {
+        Cy_WDT_Unlock();
+        Cy_SysClk_ClkLfSetSource(CY_SYSCLK_CLKLF_IN_WCO);
+        Cy_WDT_Lock();
+    }
+#endif
+
+    timebase_lfclk_hz = Cy_SysClk_ClkLfGetFrequency();
+
+    if(cyhal_lptimer_init(&timebase_timer) != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    if(cyhal_rtc_init(&timebase_rtc) != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    timebase_ticks = 0;
+    timebase_last_ticks = cyhal_lptimer_read(&timebase_timer);
+
+    /* The RTC keeps its time over a reset as long as the backup domain is
+     * powered */
+    if(cyhal_rtc_is_enabled(&timebase_rtc) && (cyhal_rtc_read(&timebase_rtc, &time) == CY_RSLT_SUCCESS))
+    {
+        seconds = timebase_tm_to_seconds(&time);
+
+        while(wait_for_rtc_tick && (timebase_tm_to_seconds(&time) == seconds))
+            (void)cyhal_rtc_read(&timebase_rtc, &time);
+
+        timebase_rtc_seconds = timebase_tm_to_seconds(&time);
+        timebase_rtc_pending = !wait_for_rtc_tick;
+        timebase_wall_offset_ms = ((uint64_t)timebase_rtc_seconds * 1000U) - timebase_get_uptime_ms();
+    }
+#else
+    (void)wait_for_rtc_tick;
+    timebase_uptime = 0;
+#endif
+}
+
+#if !ENABLE_RTC_TIMESTAMP
+/*******************************************************************************
+* Function Name: timebase_advance
+********************************************************************************
+* Summary:
+* This function adds the period of a wake-up to the time since the start of
+* sampling. The time then drifts with any error of the wake-up period.
+*
+* Parameters:
+*  period_ms: period of the wake-up in milliseconds
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void timebase_advance(uint32 period_ms)
+{
+    timebase_uptime += period_ms;
+}
+#endif
+
+/*******************************************************************************
+* Function Name: timebase_get_uptime_ms
+********************************************************************************
+* Summary:
+* This function returns the time since the start of sampling. The timer count
+* is extended to 64 bits at each call, so it must be called at least once
+* per wrap-around of the timer (2^32 LFCLK cycles, about 36 hours).
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Time since the start of sampling in milliseconds
+*
+*******************************************************************************/
+uint64_t timebase_get_uptime_ms(void)
+{
+#if ENABLE_RTC_TIMESTAMP
+    uint32 ticks = cyhal_lptimer_read(&timebase_timer);
+
+    timebase_ticks += (uint32)(ticks - timebase_last_ticks);
+    timebase_last_ticks = ticks;
+
+    return((timebase_ticks * 1000U) / timebase_lfclk_hz);
+#else
+    return(timebase_uptime);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: timebase_get_wall_ms
+********************************************************************************
+* Summary:
+* This function returns the wall-clock time. Till the time is set, either from
+* the RTC or by the host, it is the time since the start of sampling.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Wall-clock time in milliseconds since 1970-01-01 00:00:00 UTC
+*
+*******************************************************************************/
+uint64_t timebase_get_wall_ms(void)
+{
+#if ENABLE_RTC_TIMESTAMP
+    if(timebase_rtc_pending)
+        timebase_align_rtc();
+#endif
+
+    return(timebase_wall_offset_ms + timebase_get_uptime_ms());
+}
+
+/*******************************************************************************
+* Function Name: timebase_set_wall_time
+********************************************************************************
+* Summary:
+* This function sets the wall-clock time and writes it to the RTC. The RTC is
+* only read back at the next reset, so the sub-second phase of the RTC does
+* not affect the timestamps till then.
+*
+* Parameters:
+*  seconds: seconds since 1970-01-01 00:00:00 UTC
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void timebase_set_wall_time(uint32 seconds)
+{
+#if ENABLE_RTC_TIMESTAMP
+    struct tm time;
+
+    timebase_seconds_to_tm(seconds, &time);
+    (void)cyhal_rtc_write(&timebase_rtc, &time);
+    timebase_rtc_pending = false;
+#endif
+
+    timebase_wall_offset_ms = ((uint64_t)seconds * 1000U) - timebase_get_uptime_ms();
+}
+
+#if SENSING_CORE_TELEMETRY
+/*******************************************************************************
+* Function Name: timebase_receive_wall_time
+********************************************************************************
+* Summary:
+* This function reads the decimal seconds and the carriage return following
+* TIMEBASE_SET_REQUEST from the host, and sets the wall-clock time. The
+* request is dropped if a character does not arrive within
+* TIMEBASE_SET_CHAR_TIMEOUT_MS.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the wall-clock time was set
+*
+*******************************************************************************/
+bool timebase_receive_wall_time(void)
+{
+    uint32 seconds;
+
+    if(!telemetry_read_decimal(&seconds, TIMEBASE_SET_CHAR_TIMEOUT_MS))
+        return(false);
+
+    timebase_set_wall_time(seconds);
+
+    return(true);
+}
+#endif
+
+/*******************************************************************************
+* Function Name: timebase_report_due
+********************************************************************************
+* Summary:
+* This function checks whether the wall-clock time reached the scheduled time
+* of the next report, and schedules the following one at the next multiple of
+* period_ms. Devices with the same wall-clock time report in the same windows,
+* whatever their sample rate or FIFO level; the report is sent at the first
+* wake-up after the boundary. A report is also due when the wall-clock time
+* was set back by more than one period.
+*
+* Parameters:
+*  next_ms: scheduled time of the next report; 0 to report at once
+*  period_ms: report interval in milliseconds
+*
+* Return:
+*  true if a report is due
+*
+*******************************************************************************/
+bool timebase_report_due(uint64_t *next_ms, uint32 period_ms)
+{
+    uint64_t now_ms = timebase_get_wall_ms();
+
+    if((now_ms < *next_ms) && ((*next_ms - now_ms) <= period_ms))
+        return(false);
+
+    *next_ms = ((now_ms / period_ms) + 1U) * period_ms;
+
+    return(true);
+}
+
+#if ENABLE_RTC_TIMESTAMP
+/*******************************************************************************
+* Function Name: timebase_tm_to_seconds
+********************************************************************************
+* Summary:
+* This function converts a calendar time to seconds since 1970-01-01 UTC.
+*
+* Parameters:
+*  time: calendar time; tm_year counts from 1900 and tm_mon from 0
+*
+* Return:
+*  Seconds since 1970-01-01 00:00:00 UTC
+*
+*******************************************************************************/
+static uint32 timebase_tm_to_seconds(const struct tm *time)
+{
+    /* Years start on March 1st, so the leap day is the last day of a year */
+    int32 year = (int32)time->tm_year + 1900 - ((time->tm_mon < 2) ? 1 : 0);
+    int32 month = (int32)time->tm_mon + ((time->tm_mon < 2) ? 10 : -2);
+    int32 era = year / 400;
+    int32 year_of_era = year - (era * 400);
+    int32 day_of_year = ((153 * month) + 2) / 5 + (int32)time->tm_mday - 1;
+    int32 day_of_era = (year_of_era * 365) + (year_of_era / 4) - (year_of_era / 100) + day_of_year;
+    int32 days = (era * TIMEBASE_DAYS_PER_ERA) + day_of_era - TIMEBASE_DAYS_TO_EPOCH;
+
+    return(((uint32)days * 86400UL) + ((uint32)time->tm_hour * 3600UL) +
+           ((uint32)time->tm_min * 60UL) + (uint32)time->tm_sec);
+}
+
+/*******************************************************************************
+* Function Name: timebase_seconds_to_tm
+********************************************************************************
+* Summary:
+* This function converts seconds since 1970-01-01 UTC to a calendar time.
+*
+* Parameters:
+*  seconds: seconds since 1970-01-01 00:00:00 UTC
+*  time: calendar time
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void timebase_seconds_to_tm(uint32 seconds, struct tm *time)
+{
+    int32 days = (int32)(seconds / 86400UL) + TIMEBASE_DAYS_TO_EPOCH;
+    uint32 second_of_day = seconds % 86400UL;
+    int32 era = days / TIMEBASE_DAYS_PER_ERA;
+    int32 day_of_era = days - (era * TIMEBASE_DAYS_PER_ERA);
+    int32 year_of_era = (day_of_era - (day_of_era / 1460) + (day_of_era / 36524) - (day_of_era / 146096)) / 365;
+    int32 day_of_year = day_of_era - ((365 * year_of_era) + (year_of_era / 4) - (year_of_era / 100));
+    int32 month = ((5 * day_of_year) + 2) / 153;
+
+    memset(time, 0, sizeof(*time));
+    time->tm_mday = (int)(day_of_year - (((153 * month) + 2) / 5) + 1);
+    time->tm_mon = (int)((month < 10) ? (month + 2) : (month - 10));
+    time->tm_year = (int)((year_of_era + (era * 400) + ((time->tm_mon < 2) ? 1 : 0)) - 1900);
+    time->tm_wday = (int)((((seconds / 86400UL) + 4UL) % 7UL));
+    time->tm_hour = (int)(second_of_day / 3600UL);
+    time->tm_min = (int)((second_of_day / 60UL) % 60UL);
+    time->tm_sec = (int)(second_of_day % 60UL);
+}
+
+/*******************************************************************************
+* Function Name: timebase_align_rtc
+********************************************************************************
+* Summary:
+* This function checks whether the RTC moved to the next second since the
+* startup, and aligns the wall-clock time to the tick if so. The time steps
+* forward once, by less than one second; the step is late by up to one
+* wake-up period.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void timebase_align_rtc(void)
+{
+    struct tm time;
+    uint32 seconds;
+
+    if(cyhal_rtc_read(&timebase_rtc, &time) != CY_RSLT_SUCCESS)
+        return;
+
+    seconds = timebase_tm_to_seconds(&time);
+
+    if(seconds != timebase_rtc_seconds)
+    {
+        timebase_rtc_pending = false;
+        timebase_wall_offset_ms = ((uint64_t)seconds * 1000U) - timebase_get_uptime_ms();
+    }
+}
+#endif
+
+/* [] END OF FILE */
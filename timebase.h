@@ -0,0 +1,97 @@
+/******************************************************************************
+* File Name: timebase.h
+*
+* Description: This file contains the declarations of the time base of the
+*              readings: the time since the start of sampling and the wall-clock
+*              time kept by the RTC, and the scheduling of the UART reports.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Character sent by the host to set the wall-clock time; it is followed by the
+ * number of seconds since 1970-01-01 00:00:00 UTC and a carriage return, for
+ * example "T1760000000\r" */
+#define TIMEBASE_SET_REQUEST                ('T')
+
+/* Time allowed for each character of the set request */
+#define TIMEBASE_SET_CHAR_TIMEOUT_MS        (20U)
+
+/* Time allowed for the WCO to start */
+#define TIMEBASE_WCO_TIMEOUT_US             (1000000UL)
+
+/* Milliseconds per day */
+#define TIMEBASE_MS_PER_DAY                 (86400000UL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to start the low-power timer and load the wall-clock time from the RTC */
+void timebase_init(bool wait_for_rtc_tick);
+
+#if !ENABLE_RTC_TIMESTAMP
+/* Function to account for a wake-up period when no timer is used */
+void timebase_advance(uint32 period_ms);
+#else
+#define timebase_advance(period_ms)         ((void)(period_ms))
+#endif
+
+/* Function to get the time since the start of sampling in milliseconds */
+uint64_t timebase_get_uptime_ms(void);
+
+/* Function to get the wall-clock time in milliseconds since 1970-01-01 UTC */
+uint64_t timebase_get_wall_ms(void);
+
+/* Function to set the wall-clock time and the RTC */
+void timebase_set_wall_time(uint32 seconds);
+
+/* Function to read the set request from the host and set the wall-clock time */
+bool timebase_receive_wall_time(void);
+
+/* Function to check whether a report is due and schedule the next one */
+bool timebase_report_due(uint64_t *next_ms, uint32 period_ms);
+
+#endif /* TIMEBASE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,556 @@
+/******************************************************************************
+* File Name: trend.c
+*
+* Description: This file contains the incremental statistics, the sliding-window
+*              slope and the alarm rules of the sensor outputs. Each sample is
+*              processed in constant time, and an event is sent only when a rule
+*              fires.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "trend.h"
+
+#if ENABLE_TREND_ALARMS
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Samples per minute, for the slope */
+#define TREND_SAMPLES_PER_MINUTE            (60000UL / TREND_SAMPLE_PERIOD_MS)
+
+/* Denominator of the least-squares slope per sample, W * (W^2 - 1) */
+#define TREND_SLOPE_DIVISOR                 ((int64_t)TREND_WINDOW * \
+                                             (((int64_t)TREND_WINDOW * TREND_WINDOW) - 1))
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* State of a sensor output */
+typedef struct
+{
+    /* Welford state: number of samples, mean in Q16 and sum of the squared
+     * differences from the mean in Q16 */
+    uint32 count;
+    int64_t mean_q16;
+    int64_t m2_q16;
+
+    /* Lowest, highest and previous sample */
+    int32 min;
+    int32 max;
+    int32 last;
+
+    /* Sliding window; head is the oldest sample once the window is full */
+    int32 window[TREND_WINDOW];
+    uint8 head;
+
+    /* Sum of the samples of the window, and sum of the samples weighted by
+     * their position from 0 (oldest) to TREND_WINDOW - 1 (newest) */
+    int32 sum;
+    int32 weighted_sum;
+} trend_sensor_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void trend_add_sample(trend_sensor_t *state, int32 value);
+
+static int32 trend_get_slope(const trend_sensor_t *state);
+
+static void trend_evaluate(uint8 index, const telemetry_reading_t *reading);
+
+static uint32 trend_sqrt(uint32 value);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Rules loaded by trend_init */
+static const trend_rule_t trend_default_rules[] =
+{
+    {
+        .name = "Temperature rising",
+        .sensor = SENSOR_TEMPERATURE_INDEX,
+        .type = TREND_RULE_RISING,
+        .threshold = 100,
+        .hysteresis = 50
+    },
+    {
+        .name = "Temperature falling",
+        .sensor = SENSOR_TEMPERATURE_INDEX,
+        .type = TREND_RULE_FALLING,
+        .threshold = -100,
+        .hysteresis = 50
+    },
+    {
+        .name = "Temperature high",
+        .sensor = SENSOR_TEMPERATURE_INDEX,
+        .type = TREND_RULE_ABOVE,
+        .threshold = 4000,
+        .hysteresis = 100
+    },
+    {
+        .name = "Light dropped",
+        .sensor = SENSOR_LIGHT_INDEX,
+        .type = TREND_RULE_STEP_DOWN,
+        .threshold = -20,
+        .hysteresis = 15
+    }
+};
+
+/* State of every sensor output */
+static trend_sensor_t trend_sensors[SENSOR_COUNT];
+
+/* Rule table; entries of type TREND_RULE_NONE are skipped */
+static trend_rule_t trend_rules[TREND_MAX_RULES];
+
+/* Bit per rule: set while the rule has fired and is not re-armed */
+static uint32 trend_active_mask = 0;
+
+/* Bit per rule: set while the event of the rule is waiting for the UART */
+static uint32 trend_pending_mask = 0;
+
+/* Event of each rule, captured when the rule fired */
+static telemetry_event_t trend_events[TREND_MAX_RULES];
+
+
+/*******************************************************************************
+* Function Name: trend_init
+********************************************************************************
+* Summary:
+* This function clears the statistics of every sensor output and loads the
+* default rules.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void trend_init(void)
+{
+    uint8 index;
+
+    memset(trend_sensors, 0, sizeof(trend_sensors));
+    memset(trend_rules, 0, sizeof(trend_rules));
+
+    for(index = 0; index < (sizeof(trend_default_rules) / sizeof(trend_default_rules[0])); index++)
+    {
+        if(!trend_set_rule(index, &trend_default_rules[index]))
+        {
+            CY_ASSERT(0);
+        }
+    }
+
+    trend_active_mask = 0;
+    trend_pending_mask = 0;
+}
+
+/*******************************************************************************
+* Function Name: trend_update
+********************************************************************************
+* Summary:
+* This function adds a sample of every sensor output to its statistics and its
+* sliding window, and evaluates the rules. It is called at every
+* TREND_SAMPLE_PERIOD_MS boundary; the cost does not depend on the window
+* length.
+*
+* Parameters:
+*  values: output of each entry of the sensor table
+*  reading: reading of this wake-up, for the timestamps of the events
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void trend_update(const int32 *values, const telemetry_reading_t *reading)
+{
+    uint8 index;
+
+    for(index = 0; index < SENSOR_COUNT; index++)
+    {
+        if(sensor_table[index].convert != NULL)
+            trend_add_sample(&trend_sensors[index], values[index]);
+    }
+
+    for(index = 0; index < TREND_MAX_RULES; index++)
+    {
+        if(trend_rules[index].type != TREND_RULE_NONE)
+            trend_evaluate(index, reading);
+    }
+}
+
+/*******************************************************************************
+* Function Name: trend_send_event
+********************************************************************************
+* Summary:
+* This function sends the event of the lowest-numbered rule that fired since
+* the last call, if the UART is free. An event not yet sent is replaced if its
+* rule fires again.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if an event is sent
+*
+*******************************************************************************/
+bool trend_send_event(void)
+{
+    uint8 buffer[TELEMETRY_BUFFER_SIZE];
+    uint8 index = 0;
+
+    if((trend_pending_mask == 0UL) || telemetry_is_busy())
+        return(false);
+
+    while((trend_pending_mask & (1UL << index)) == 0UL)
+        index++;
+
+    trend_pending_mask &= ~(1UL << index);
+
+    return(telemetry_write(buffer, telemetry_format_event(buffer, &trend_events[index])));
+}
+
+/*******************************************************************************
+* Function Name: trend_set_rule
+********************************************************************************
+* Summary:
+* This function replaces an entry of the rule table. The rule starts armed.
+* Pass a rule of type TREND_RULE_NONE to remove the entry.
+*
+* Parameters:
+*  index: entry of the rule table
+*  rule: new rule; the name is referenced, not copied
+*
+* Return:
+*  true if the rule is valid
+*
+*******************************************************************************/
+bool trend_set_rule(uint8 index, const trend_rule_t *rule)
+{
+    if(index >= TREND_MAX_RULES)
+        return(false);
+
+    if((rule->type != TREND_RULE_NONE) &&
+       ((rule->name == NULL) || (rule->sensor >= SENSOR_COUNT) ||
+        (sensor_table[rule->sensor].convert == NULL) || (rule->hysteresis < 0)))
+        return(false);
+
+    trend_rules[index] = *rule;
+    trend_active_mask &= ~(1UL << index);
+    trend_pending_mask &= ~(1UL << index);
+
+    return(true);
+}
+
+/*******************************************************************************
+* Function Name: trend_get_stats
+********************************************************************************
+* Summary:
+* This function gets the statistics of a sensor output.
+*
+* Parameters:
+*  sensor: entry of the sensor table
+*  stats: structure to receive the statistics
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void trend_get_stats(uint8 sensor, trend_stats_t *stats)
+{
+    const trend_sensor_t *state = &trend_sensors[sensor];
+
+    stats->count = state->count;
+    stats->min = state->min;
+    stats->max = state->max;
+    stats->mean_q8 = (int32)((state->mean_q16 + 128) >> 8);
+    stats->variance = (state->count > 1UL) ?
+                      (uint32)((state->m2_q16 / (int64_t)(state->count - 1UL)) >> 16) : 0UL;
+    stats->slope = trend_get_slope(state);
+}
+
+/*******************************************************************************
+* Function Name: trend_report
+********************************************************************************
+* Summary:
+* This function prints the statistics of every sensor output and the state of
+* every rule over the debug UART.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void trend_report(void)
+{
+    trend_stats_t stats;
+    uint8 index;
+
+    printf("\r\n");
+
+    for(index = 0; index < SENSOR_COUNT; index++)
+    {
+        if(sensor_table[index].convert == NULL)
+            continue;
+
+        trend_get_stats(index, &stats);
+        printf("Sensor %u: %lu samples  min %ld  max %ld  mean %ld  std dev %lu  slope %ld/min\r\n",
+               index, (unsigned long)stats.count, (long)stats.min, (long)stats.max,
+               (long)((stats.mean_q8 + 128) >> 8), (unsigned long)trend_sqrt(stats.variance),
+               (long)stats.slope);
+    }
+
+    for(index = 0; index < TREND_MAX_RULES; index++)
+    {
+        if(trend_rules[index].type != TREND_RULE_NONE)
+            printf("Alarm %u %s: %s\r\n", index, trend_rules[index].name,
+                   ((trend_active_mask & (1UL << index)) != 0UL) ? "fired" : "armed");
+    }
+}
+
+/*******************************************************************************
+* Function Name: trend_add_sample
+********************************************************************************
+* Summary:
+* This function adds a sample to the state of a sensor output. The mean and the
+* variance are updated with Welford's method, which needs no stored history.
+* The window sums are updated by removing the oldest sample: every remaining
+* sample moves one position back, which lowers the weighted sum by the sum of
+* the remaining samples.
+*
+* Parameters:
+*  state: state of the sensor output
+*  value: new sample
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void trend_add_sample(trend_sensor_t *state, int32 value)
+{
+    int64_t value_q16 = (int64_t)value * 65536;
+    int64_t delta;
+    int32 oldest;
+
+    if(state->count == 0UL)
+    {
+        state->min = value;
+        state->max = value;
+    }
+
+    if(value < state->min)
+        state->min = value;
+
+    if(value > state->max)
+        state->max = value;
+
+    /* The division is rounded so that the error of the mean does not build
+     * up over the samples */
+    state->count++;
+    delta = value_q16 - state->mean_q16;
+    state->mean_q16 += ((delta < 0) ? (delta - (int64_t)(state->count / 2UL)) :
+                                      (delta + (int64_t)(state->count / 2UL))) / (int64_t)state->count;
+    state->m2_q16 += (delta * (value_q16 - state->mean_q16)) >> 16;
+
+    if(state->count <= TREND_WINDOW)
+    {
+        /* Filling: the new sample takes the next position */
+        state->weighted_sum += (int32)(state->count - 1UL) * value;
+        state->sum += value;
+        state->window[state->count - 1UL] = value;
+    }
+    else
+    {
+        oldest = state->window[state->head];
+        state->weighted_sum += ((int32)(TREND_WINDOW - 1U) * value) - (state->sum - oldest);
+        state->sum += value - oldest;
+        state->window[state->head] = value;
+        state->head = (uint8)((state->head + 1U) % TREND_WINDOW);
+    }
+
+    state->last = value;
+}
+
+/*******************************************************************************
+* Function Name: trend_get_slope
+********************************************************************************
+* Summary:
+* This function calculates the least-squares slope of the sliding window from
+* its two running sums:
+* slope = (12 * weighted_sum - 6 * (W - 1) * sum) / (W * (W^2 - 1)).
+*
+* Parameters:
+*  state: state of the sensor output
+*
+* Return:
+*  Slope per minute; 0 till the window is full
+*
+*******************************************************************************/
+static int32 trend_get_slope(const trend_sensor_t *state)
+{
+    int64_t numerator;
+
+    if(state->count < TREND_WINDOW)
+        return(0);
+
+    numerator = (12 * (int64_t)state->weighted_sum) - (6 * (int64_t)(TREND_WINDOW - 1U) * state->sum);
+
+    return((int32)(numerator * (int64_t)TREND_SAMPLES_PER_MINUTE / TREND_SLOPE_DIVISOR));
+}
+
+/*******************************************************************************
+* Function Name: trend_evaluate
+********************************************************************************
+* Summary:
+* This function evaluates a rule against the latest sample of its sensor
+* output. When the rule fires, its event is captured and left pending for
+* trend_send_event.
+*
+* Parameters:
+*  index: entry of the rule table
+*  reading: reading of this wake-up, for the timestamps of the event
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void trend_evaluate(uint8 index, const telemetry_reading_t *reading)
+{
+    const trend_rule_t *rule = &trend_rules[index];
+    const trend_sensor_t *state = &trend_sensors[rule->sensor];
+    uint32 bit = 1UL << index;
+    int32 value = state->last;
+    int32 slope = trend_get_slope(state);
+    int32 quantity;
+    bool above;
+
+    switch(rule->type)
+    {
+        case TREND_RULE_ABOVE:
+        case TREND_RULE_BELOW:
+            quantity = value;
+            break;
+
+        case TREND_RULE_RISING:
+        case TREND_RULE_FALLING:
+            /* Skipped till the window is full */
+            if(state->count < TREND_WINDOW)
+                return;
+
+            quantity = slope;
+            break;
+
+        default:
+            /* Steps need two samples */
+            if(state->count < 2UL)
+                return;
+
+            quantity = value - state->window[(state->count <= TREND_WINDOW) ?
+                                             (state->count - 2UL) :
+                                             ((state->head + TREND_WINDOW - 2U) % TREND_WINDOW)];
+            break;
+    }
+
+    above = (rule->type == TREND_RULE_ABOVE) || (rule->type == TREND_RULE_RISING) ||
+            (rule->type == TREND_RULE_STEP_UP);
+
+    if((trend_active_mask & bit) == 0UL)
+    {
+        if(above ? (quantity > rule->threshold) : (quantity < rule->threshold))
+        {
+            trend_active_mask |= bit;
+            trend_pending_mask |= bit;
+
+            trend_events[index].timestamp_ms = reading->timestamp_ms;
+            trend_events[index].time_of_day_ms = reading->time_of_day_ms;
+            trend_events[index].rule = index;
+            trend_events[index].name = rule->name;
+            trend_events[index].value = value;
+            trend_events[index].slope = slope;
+        }
+    }
+    else if(above ? (quantity <= (rule->threshold - rule->hysteresis)) :
+                    (quantity >= (rule->threshold + rule->hysteresis)))
+    {
+        trend_active_mask &= ~bit;
+    }
+}
+
+/*******************************************************************************
+* Function Name: trend_sqrt
+********************************************************************************
+* Summary:
+* This function calculates the integer square root, rounded down.
+*
+* Parameters:
+*  value: value to take the root of
+*
+* Return:
+*  Square root
+*
+*******************************************************************************/
+static uint32 trend_sqrt(uint32 value)
+{
+    uint32 root = 0;
+    uint32 bit = 1UL << 30;
+
+    while(bit > value)
+        bit >>= 2;
+
+    while(bit != 0UL)
+    {
+        if(value >= (root + bit))
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+
+        bit >>= 2;
+    }
+
+    return(root);
+}
+#endif /* ENABLE_TREND_ALARMS */
+
+/* [] END OF FILE */
@@ -0,0 +1,149 @@
+/******************************************************************************
+* File Name: trend.h
+*
+* Description: This file contains the interface of the incremental statistics,
+*              trend detection and alarm rules of the sensor outputs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TREND_H_
+#define TREND_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+#include "sensor_table.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Interval of the samples taken from the sensor outputs in milliseconds; the
+ * samples are taken at boundaries of the wall-clock time so that they are
+ * evenly spaced at any wake-up period up to this interval */
+#define TREND_SAMPLE_PERIOD_MS              (1000U)
+
+/* Number of samples of the sliding window the slope is fitted over */
+#define TREND_WINDOW                        (30U)
+
+/* Number of entries of the rule table */
+#define TREND_MAX_RULES                     (8U)
+
+/* Command character sent by the host to print the statistics and the state
+ * of the rules */
+#define TREND_REPORT_REQUEST                ('A')
+
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Quantity a rule compares against its threshold */
+typedef enum
+{
+    TREND_RULE_NONE,                /* Unused entry */
+    TREND_RULE_ABOVE,               /* Sensor output above the threshold */
+    TREND_RULE_BELOW,               /* Sensor output below the threshold */
+    TREND_RULE_RISING,              /* Slope per minute above the threshold */
+    TREND_RULE_FALLING,             /* Slope per minute below the threshold */
+    TREND_RULE_STEP_UP,             /* Change since the previous sample above the threshold */
+    TREND_RULE_STEP_DOWN            /* Change since the previous sample below the threshold */
+} trend_rule_type_t;
+
+/* Alarm rule. A rule fires once when its condition becomes true, and is
+ * re-armed when the quantity is back by the hysteresis on the other side of the
+ * threshold. Thresholds of the FALLING and STEP_DOWN rules are negative. */
+typedef struct
+{
+    /* Name printed in the ASCII event */
+    const char *name;
+
+    /* Entry of the sensor table; the sensor must have an output */
+    uint8 sensor;
+
+    /* Quantity compared against the threshold */
+    trend_rule_type_t type;
+
+    /* Threshold in the units of the sensor output: 0.01 deg C or percentage,
+     * per minute for the slope */
+    int32 threshold;
+
+    /* Distance from the threshold at which the rule is re-armed */
+    int32 hysteresis;
+} trend_rule_t;
+
+/* Statistics of a sensor output since the start of sampling */
+typedef struct
+{
+    /* Number of samples */
+    uint32 count;
+
+    /* Lowest and highest sample */
+    int32 min;
+    int32 max;
+
+    /* Mean in 1/256 of the unit of the sensor output */
+    int32 mean_q8;
+
+    /* Sample variance in the unit of the sensor output squared */
+    uint32 variance;
+
+    /* Slope of the sliding window per minute; 0 till the window is full */
+    int32 slope;
+} trend_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to clear the statistics and load the default rules */
+void trend_init(void);
+
+/* Function to add a sample of every sensor output and evaluate the rules */
+void trend_update(const int32 *values, const telemetry_reading_t *reading);
+
+/* Function to send a pending alarm event */
+bool trend_send_event(void);
+
+/* Function to replace an entry of the rule table */
+bool trend_set_rule(uint8 index, const trend_rule_t *rule);
+
+/* Function to get the statistics of a sensor output */
+void trend_get_stats(uint8 sensor, trend_stats_t *stats);
+
+/* Function to print the statistics and the state of the rules */
+void trend_report(void);
+
+#endif /* TREND_H_ */
+
+/* [] END OF FILE */
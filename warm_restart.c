@@ -0,0 +1,241 @@
+/******************************************************************************
+* File Name: warm_restart.c
+*
+* Description: This file contains the watchdog and the state retained across a
+*              watchdog or a software reset: the filter outputs and the sequence
+*              number of the binary frames, which let the readings continue settled
+*              after the restart.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include <stddef.h>
+#include "cyhal.h"
+#include "filter_bank.h"
+#include "sensor_table.h"
+#include "telemetry.h"
+#include "warm_restart.h"
+
+#if ENABLE_WARM_RESTART
+/*******************************************************************************
+* Data Types
+********************************************************************************/
+/* Retained state; the CRC covers the bytes before it */
+typedef struct
+{
+    uint32 magic;
+
+    /* Number of warm restarts since the last cold start */
+    uint32 restart_count;
+
+    /* Filter output of the entries of the sensor table, in ADC counts */
+    int32 filtered[SENSOR_COUNT];
+
+    /* Sequence number of the next binary frame */
+    uint16 sequence;
+
+    uint16 crc;
+} warm_restart_state_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void warm_restart_seal(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Retained state; not cleared by the startup code, so that it survives the
+ * resets that keep the SRAM powered */
+CY_NOINIT static warm_restart_state_t warm_restart_state;
+
+static cyhal_wdt_t warm_restart_wdt;
+
+/* Set when the retained state was loaded at startup */
+static bool warm_restart_warm = false;
+
+
+/*******************************************************************************
+* Function Name: warm_restart_init
+********************************************************************************
+* Summary:
+* This function checks the cause of the reset. The restart is warm after a
+* watchdog or a software reset that left a valid retained state; after any
+* other reset, the SRAM content is not defined and the state is cleared. The
+* reset cause is cleared for the next reset.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the restart is warm
+*
+*******************************************************************************/
+bool warm_restart_init(void)
+{
+    uint32 reason = (uint32)cyhal_system_get_reset_reason();
+
+    cyhal_system_clear_reset_reason();
+
+    warm_restart_warm = ((reason & ((uint32)CYHAL_SYSTEM_RESET_WDT | (uint32)CYHAL_SYSTEM_RESET_SOFT)) != 0U) &&
+                        (warm_restart_state.magic == WARM_RESTART_MAGIC) &&
+                        (warm_restart_state.crc == telemetry_crc16((const uint8 *)&warm_restart_state,
+                                                                   offsetof(warm_restart_state_t, crc)));
+
+    if(warm_restart_warm)
+    {
+        warm_restart_state.restart_count++;
+    }
+    else
+    {
+        memset(&warm_restart_state, 0, sizeof(warm_restart_state));
+        warm_restart_state.magic = WARM_RESTART_MAGIC;
+    }
+
+    warm_restart_seal();
+
+    return(warm_restart_warm);
+}
+
+/*******************************************************************************
+* Function Name: warm_restart_start
+********************************************************************************
+* Summary:
+* This function loads the filters with the retained outputs after a warm
+* restart, so that the first reading is settled, and continues the sequence
+* numbers of the binary frames. It then starts the watchdog, which resets the
+* device unless warm_restart_update is called every
+* WARM_RESTART_WDT_TIMEOUT_MS. This function must be called after the filters
+* are configured and retuned, and after the LFCLK source is selected.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void warm_restart_start(void)
+{
+    cy_rslt_t result;
+    uint8 sensor;
+
+    if(warm_restart_warm)
+    {
+        for(sensor = 0; sensor < SENSOR_COUNT; sensor++)
+            filter_bank_preload(sensor_table[sensor].channel, warm_restart_state.filtered[sensor]);
+
+        telemetry_set_sequence(warm_restart_state.sequence);
+    }
+
+    result = cyhal_wdt_init(&warm_restart_wdt, WARM_RESTART_WDT_TIMEOUT_MS);
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: warm_restart_update
+********************************************************************************
+* Summary:
+* This function retains the filter outputs of a wake-up and the sequence
+* number of the next binary frame, and kicks the watchdog. It is called once
+* per processed wake-up, so the watchdog also resets the device when the
+* FIFO interrupts stop.
+*
+* Parameters:
+*  filtered_data: filter output of each SAR channel
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void warm_restart_update(const int32 *filtered_data)
+{
+    uint8 sensor;
+
+    for(sensor = 0; sensor < SENSOR_COUNT; sensor++)
+        warm_restart_state.filtered[sensor] = filtered_data[sensor_table[sensor].channel];
+
+    warm_restart_state.sequence = telemetry_get_sequence();
+    warm_restart_seal();
+
+    cyhal_wdt_kick(&warm_restart_wdt);
+}
+
+/*******************************************************************************
+* Function Name: warm_restart_get_count
+********************************************************************************
+* Summary:
+* This function returns the number of warm restarts since the last cold start.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of warm restarts
+*
+*******************************************************************************/
+uint32 warm_restart_get_count(void)
+{
+    return(warm_restart_state.restart_count);
+}
+
+/*******************************************************************************
+* Function Name: warm_restart_seal
+********************************************************************************
+* Summary:
+* This function updates the CRC of the retained state. A reset during the
+* update leaves a state that fails the check, which gives a cold start.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void warm_restart_seal(void)
+{
+    warm_restart_state.crc = telemetry_crc16((const uint8 *)&warm_restart_state,
+                                             offsetof(warm_restart_state_t, crc));
+}
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,76 @@
+/******************************************************************************
+* File Name: warm_restart.h
+*
+* Description: This file contains the declarations of the watchdog and of the
+*              state retained across a watchdog or a software reset.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef WARM_RESTART_H_
+#define WARM_RESTART_H_
+
+#include "cy_pdl.h"
+#include "app_config.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Watchdog timeout; well above the longest wake-up period, 1s in range
+ * detection mode */
+#define WARM_RESTART_WDT_TIMEOUT_MS         (4000U)
+
+/* Marks the retained state as written by this application */
+#define WARM_RESTART_MAGIC                  (0x5741524DUL)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Function to check whether the reset left a valid retained state */
+bool warm_restart_init(void);
+
+/* Function to load the retained state and start the watchdog */
+void warm_restart_start(void);
+
+/* Function to retain the state of a wake-up and kick the watchdog */
+void warm_restart_update(const int32 *filtered_data);
+
+/* Function to get the number of warm restarts since the power-up */
+uint32 warm_restart_get_count(void);
+
+#endif /* WARM_RESTART_H_ */
+
+/* [] END OF FILE */